@@ -0,0 +1,86 @@
+#ifndef ALLOC_SET_CONTEXT_H
+#define ALLOC_SET_CONTEXT_H
+
+#include <vector>
+#include <memory>
+#include "pg/palloc.h"
+
+// Arena memory context (T_AllocSetContext)
+// Chunks are carved sequentially from big blocks, pfree of a single
+// chunk does nothing, all memory is released at once by reset()
+// or destruction of the context. Node destructors are not called then.
+//
+// Context is not thread safe, it is meant to be current in one thread
+// at a time: every worker switches to its own arena while building trees
+//     auto arena = std::make_unique<AllocSetContext>();
+//     MemoryContextScope scope(arena.get());
+// and a finished tree can be passed to other thread together with
+// its arena (std::unique_ptr<AllocSetContext>). pfree from any thread
+// is safe as it does not touch the arena.
+struct AllocSetContext : public MemoryContextData
+{
+    static const size_t DefaultBlockSize = MemoryGranuleSize;
+
+    // Block size is rounded up to whole granules (see palloc.h)
+    explicit AllocSetContext(size_t blockSize = DefaultBlockSize)
+        :MemoryContextData(T_AllocSetContext), blockSize(granuleAlign(blockSize)), freePtr(nullptr), endPtr(nullptr), allocated(0) {}
+    ~AllocSetContext() { reset(); }
+
+    void* allocChunk(size_t size) override
+    {
+        size = maxAlign(size);
+        if (size > static_cast<size_t>(endPtr - freePtr)) {
+            if (size > blockSize / 4) {
+                // big chunk gets its own block, current one is still used
+                return addBlock(granuleAlign(size));
+            }
+            freePtr = static_cast<char*>(addBlock(blockSize));
+            endPtr = freePtr + blockSize;
+        }
+        void* chunk = freePtr;
+        freePtr += size;
+        return chunk;
+    }
+
+    void freeChunk(void*) override {}
+
+    // Releases all memory of the context
+    void reset()
+    {
+        for (auto& block : blocks) freeMemoryBlock(block.first, block.second);
+        blocks.clear();
+        freePtr = endPtr = nullptr;
+        allocated = 0;
+    }
+
+    // Bytes taken from the heap by this context
+    size_t allocatedBytes() const { return allocated; }
+
+private:
+    AllocSetContext(const AllocSetContext&);
+    AllocSetContext& operator=(const AllocSetContext&);
+
+    size_t blockSize;
+    char* freePtr;
+    char* endPtr;
+    size_t allocated;
+    // blocks and their sizes
+    std::vector<std::pair<void*, size_t>> blocks;
+
+    void* addBlock(size_t size)
+    {
+        blocks.reserve(blocks.size() + 1);
+        void* block = allocMemoryBlock(size);
+        try {
+            mapMemoryBlock(block, size, this);
+        } catch (...) {
+            freeMemoryBlock(block, size);
+            throw;
+        }
+        blocks.emplace_back(block, size);
+        allocated += size;
+        return block;
+    }
+};
+
+#endif
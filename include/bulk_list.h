@@ -0,0 +1,218 @@
+#ifndef BULK_LIST_H
+#define BULK_LIST_H
+
+#include <atomic>
+#include <iterator>
+#include <string>
+#include "list_tools.h"
+
+// Bulk List construction
+// When number of elements is known up front, all cells (and for Ident lists
+// also all Idents and their names) are carved from one block of memory
+// and linked in a single pass, instead of one allocation per element.
+// Elements still can be released one by one (erase, clean, delete node),
+// block is returned to the heap when its last chunk is released.
+// If a memory context is current, elements are allocated from it instead.
+
+// Memory context of a block carved into chunks of bulk built lists
+// Blocks take whole granules (see palloc.h), so lists built one after
+// another in a thread share the current block of the thread until it is
+// full. Block counts its chunks that are not released yet (and the thread
+// while the block is current), it is freed when the count drops to zero.
+struct BulkBlockContext : public MemoryContextData
+{
+    static const size_t DefaultBlockSize = MemoryGranuleSize;
+
+    // Returns block of this thread with room for chunks of given total size
+    // (see chunkSize), chunkCount chunks are accounted to it
+    static BulkBlockContext* reserve(size_t chunksSize, size_t chunkCount)
+    {
+        BulkBlockContext*& current = currentBlock().block;
+        if (!current || static_cast<size_t>(current->end - current->cursor) < chunksSize) {
+            size_t size = headerSize() + chunksSize;
+            BulkBlockContext* block = create(size < DefaultBlockSize ? DefaultBlockSize : size);
+            if (current) current->release(1);
+            current = block;
+        }
+        current->references.fetch_add(chunkCount, std::memory_order_relaxed);
+        return current;
+    }
+
+    // Space taken in the block by chunk of size bytes
+    static size_t chunkSize(size_t size) { return maxAlign(size); }
+
+    void* allocChunk(size_t size) override
+    {
+        void* chunk = cursor;
+        cursor += chunkSize(size);
+        return chunk;
+    }
+
+    void freeChunk(void*) override { release(1); }
+
+private:
+    // Block current in a thread, released at thread exit
+    struct CurrentBlock
+    {
+        BulkBlockContext* block = nullptr;
+        ~CurrentBlock() { if (block) block->release(1); }
+    };
+
+    static CurrentBlock& currentBlock()
+    {
+        static thread_local CurrentBlock current;
+        return current;
+    }
+
+    static size_t headerSize() { return maxAlign(sizeof(BulkBlockContext)); }
+
+    // Creates block of size bytes (rounded to granules) held by current thread
+    static BulkBlockContext* create(size_t size)
+    {
+        size = granuleAlign(size);
+        char* memory = static_cast<char*>(allocMemoryBlock(size));
+        auto block = new (memory) BulkBlockContext(memory + headerSize(), memory + size);
+        try {
+            mapMemoryBlock(memory, size, block);
+        } catch (...) {
+            freeMemoryBlock(memory, size);
+            throw;
+        }
+        return block;
+    }
+
+    BulkBlockContext(char* begin, char* end)
+        :MemoryContextData(T_BulkBlockContext), references(1), cursor(begin), end(end) {}
+    BulkBlockContext(const BulkBlockContext&);
+    BulkBlockContext& operator=(const BulkBlockContext&);
+
+    void release(size_t count)
+    {
+        if (references.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            char* memory = reinterpret_cast<char*>(this);
+            size_t size = static_cast<size_t>(end - memory);
+            this->~BulkBlockContext();
+            freeMemoryBlock(memory, size);
+        }
+    }
+
+    std::atomic<size_t> references;
+    char* cursor;
+    char* end;
+};
+
+// Returns context for count chunks of given total size
+// (block or current memory context)
+MemoryContext bulkContext(size_t chunksSize, size_t chunkCount)
+{
+    if (currentMemoryContext()) return currentMemoryContext();
+    return BulkBlockContext::reserve(chunksSize, chunkCount);
+}
+
+// Links count cells created by makeCell at the end of list
+template<typename MakeCell>
+void appendCells(List& list, size_t count, MakeCell makeCell)
+{
+    for (size_t i = 0; i < count; ++i) {
+        ListCell* cell = makeCell(i);
+        if (list.tail) list.tail->next = cell;
+        else list.head = cell;
+        list.tail = cell;
+    }
+    list.length += static_cast<int>(count);
+}
+
+// Appends elements (int or Node*) of [first, last) to list
+// All cells are allocated in one block
+template<typename ForwardIt>
+void appendRange(List& list, ForwardIt first, ForwardIt last)
+{
+    typedef typename std::iterator_traits<ForwardIt>::value_type ValueType;
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (!count) return;
+
+    MemoryContext context = bulkContext(count * BulkBlockContext::chunkSize(sizeof(ListCell)), count);
+    appendCells(list, count, [&](size_t) {
+        ListCell* cell = ::new (pallocIn(context, sizeof(ListCell))) ListCell();
+        return AssignemntTypeChooser<ValueType>::assign(cell, *first++);
+    });
+}
+
+// Creates List of elements (int or Node*) of [first, last)
+template<typename ForwardIt>
+List makeListFrom(ForwardIt first, ForwardIt last)
+{
+    List list = makeList();
+    appendRange(list, first, last);
+    return list;
+}
+
+// Creates List of given elements (all int or all Node*)
+template<typename ValueType, typename... Values>
+List list_make_n(ValueType value, Values... values)
+{
+    ValueType elements[] = { value, values... };
+    return makeListFrom(std::begin(elements), std::end(elements));
+}
+
+// Creates List of count nodes in one block
+// makeNode(context) is called once per element in list order, it creates
+// the node allocating its memory with pallocIn(context, ...).
+// Nodes take chunkCount chunks in total, chunksSize is sum of their
+// BulkBlockContext::chunkSize (upper bound). Cells are added to both.
+template<typename MakeNode>
+List makeNodeList(size_t count, size_t chunksSize, size_t chunkCount, MakeNode makeNode)
+{
+    List list = makeList();
+    if (!count) return list;
+
+    chunksSize += count * BulkBlockContext::chunkSize(sizeof(ListCell));
+    MemoryContext context = bulkContext(chunksSize, chunkCount + count);
+    appendCells(list, count, [&](size_t) {
+        Node* node = makeNode(context);
+        ListCell* cell = ::new (pallocIn(context, sizeof(ListCell))) ListCell();
+        return AssignemntTypeChooser<Node*>::assign(cell, node);
+    });
+    return list;
+}
+
+// Creates List of count Idents, names take nameChars characters in total
+// (without terminators). Cells, Idents and names are allocated in one block.
+// nextName(allocName) is called once per Ident in list order, it has to
+// call allocName(length) once and write the name to returned buffer
+// (terminator is already there)
+template<typename NextName>
+List makeIdentList(size_t count, size_t nameChars, NextName nextName)
+{
+    // upper bound, chunkSize(sizeof(wchar_t) * (n + 1)) <= chunkSize(sizeof(wchar_t)) + sizeof(wchar_t) * n
+    size_t chunksSize = count * (BulkBlockContext::chunkSize(sizeof(IdentExt)) + BulkBlockContext::chunkSize(sizeof(wchar_t)))
+        + sizeof(wchar_t) * nameChars;
+
+    return makeNodeList(count, chunksSize, 2 * count, [&](MemoryContext context) {
+        auto ident = ::new (pallocIn(context, sizeof(IdentExt))) IdentExt();
+        ident->type = T_Ident;
+        nextName([&](size_t length) {
+            auto buffer = static_cast<wchar_t*>(pallocIn(context, sizeof(wchar_t) * (length + 1)));
+            buffer[length] = L'\0';
+            ident->name = buffer;
+            return buffer;
+        });
+        return ident;
+    });
+}
+
+// Creates List of Idents named by strings of [first, last)
+// Cells, Idents and names are allocated in one block
+template<typename ForwardIt>
+List makeIdentListFrom(ForwardIt first, ForwardIt last)
+{
+    size_t count = 0, nameChars = 0;
+    for (ForwardIt it = first; it != last; ++it, ++count) nameChars += it->size();
+
+    return makeIdentList(count, nameChars, [&](auto allocName) {
+        const std::basic_string<wchar_t>& name = *first++;
+        memcpy(allocName(name.size()), name.c_str(), sizeof(wchar_t) * name.size());
+    });
+}
+
+#endif
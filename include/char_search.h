@@ -0,0 +1,100 @@
+#ifndef CHAR_SEARCH_H
+#define CHAR_SEARCH_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define CHAR_SEARCH_SIMD 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Search of characters in narrow and wide text
+// Text is compared 16 bytes at a time with SSE2, the rest one by one.
+
+// Returns index of the lowest set bit, mask must not be 0
+inline unsigned countTrailingZeros(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#ifdef CHAR_SEARCH_SIMD
+// Lane comparison for characters of given size
+template<size_t CharSize>
+struct SimdCharCompare;
+
+template<>
+struct SimdCharCompare<1>
+{
+    static __m128i broadcast(unsigned c) { return _mm_set1_epi8(static_cast<char>(c)); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+};
+
+template<>
+struct SimdCharCompare<2>
+{
+    static __m128i broadcast(unsigned c) { return _mm_set1_epi16(static_cast<short>(c)); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+};
+
+template<>
+struct SimdCharCompare<4>
+{
+    static __m128i broadcast(unsigned c) { return _mm_set1_epi32(static_cast<int>(c)); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+};
+#endif
+
+// Returns position of first c in text[from, length), length if none
+template<typename Char>
+inline size_t findChar(const Char* text, size_t from, size_t length, Char c)
+{
+    size_t i = from;
+#ifdef CHAR_SEARCH_SIMD
+    typedef SimdCharCompare<sizeof(Char)> Compare;
+    const size_t lanes = 16 / sizeof(Char);
+    const __m128i wanted = Compare::broadcast(static_cast<unsigned>(c));
+    for (; i + lanes <= length; i += lanes) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(Compare::equal(chars, wanted)));
+        if (mask) return i + countTrailingZeros(mask) / sizeof(Char);
+    }
+#endif
+    for (; i < length; ++i) {
+        if (text[i] == c) return i;
+    }
+    return length;
+}
+
+// Returns position of first c1 or c2 in text[from, length), length if none
+template<typename Char>
+inline size_t findAnyOf(const Char* text, size_t from, size_t length, Char c1, Char c2)
+{
+    size_t i = from;
+#ifdef CHAR_SEARCH_SIMD
+    typedef SimdCharCompare<sizeof(Char)> Compare;
+    const size_t lanes = 16 / sizeof(Char);
+    const __m128i first = Compare::broadcast(static_cast<unsigned>(c1));
+    const __m128i second = Compare::broadcast(static_cast<unsigned>(c2));
+    for (; i + lanes <= length; i += lanes) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i found = _mm_or_si128(Compare::equal(chars, first), Compare::equal(chars, second));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(found));
+        if (mask) return i + countTrailingZeros(mask) / sizeof(Char);
+    }
+#endif
+    for (; i < length; ++i) {
+        if (text[i] == c1 || text[i] == c2) return i;
+    }
+    return length;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CONCURRENT_LIST_H
+#define CONCURRENT_LIST_H
+
+#include <atomic>
+#include "list_tools.h"
+
+// List that many threads can push_back to at the same time
+// Producers never take a lock: a new cell is linked to the last
+// pushed cell and published with CAS, so cells form a chain
+// in reverse push order. Single consumer takes the whole chain
+// at once and relinks it into a regular List in push order
+// (elements of one producer keep their order).
+// Cells are regular ListCells and are moved into the List without copying.
+struct ConcurrentList
+{
+    ConcurrentList() :last(nullptr), count(0) {}
+    ~ConcurrentList()
+    {
+        List rest = drain();
+        clean(rest);
+    }
+
+    // Lock-free, can be called from any thread
+    template<typename ValueType>
+    void push_back(ValueType value)
+    {
+        ListCell* cell = makeCell(value);
+        cell->next = last.load(std::memory_order_relaxed);
+        while (!last.compare_exchange_weak(cell->next, cell, std::memory_order_release, std::memory_order_relaxed)) {}
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Number of elements pushed and not drained yet
+    // (approximate while producers are running)
+    int size() const { return count.load(std::memory_order_relaxed); }
+
+    // Takes all elements pushed so far as a List
+    // Only one thread can drain at a time
+    List drain()
+    {
+        ListCell* cell = last.exchange(nullptr, std::memory_order_acquire);
+        List list = makeList();
+        list.tail = cell;
+        while (cell) {
+            ListCell* next = cell->next;
+            cell->next = list.head;
+            list.head = cell;
+            ++list.length;
+            cell = next;
+        }
+        count.fetch_sub(list.length, std::memory_order_relaxed);
+        return list;
+    }
+
+private:
+    ConcurrentList(const ConcurrentList&);
+    ConcurrentList& operator=(const ConcurrentList&);
+
+    std::atomic<ListCell*> last;
+    std::atomic<int> count;
+};
+
+#endif
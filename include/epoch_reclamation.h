@@ -0,0 +1,167 @@
+#ifndef EPOCH_RECLAMATION_H
+#define EPOCH_RECLAMATION_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include "list_tools.h"
+
+// Epoch-based reclamation of cells and nodes removed from lists
+// that are read concurrently (see PublishedList)
+// Every thread that reads or updates such lists owns EpochParticipant.
+// Reader marks critical section with EpochGuard, writer retires removed
+// memory instead of freeing it. Retired memory is freed in batches
+// once every active participant has entered a later epoch,
+// so no reader can still hold a pointer to it.
+
+struct EpochParticipant;
+
+struct RetiredPointer
+{
+    void* pointer;
+    void (*deleter)(void*);
+    uint64_t epoch;
+};
+
+struct EpochManager
+{
+    EpochManager() :globalEpoch(0) {}
+    // All participants have to be destroyed before manager
+    ~EpochManager()
+    {
+        for (auto& retired : orphans) retired.deleter(retired.pointer);
+    }
+
+    uint64_t epoch() const { return globalEpoch.load(); }
+
+private:
+    EpochManager(const EpochManager&);
+    EpochManager& operator=(const EpochManager&);
+
+    std::atomic<uint64_t> globalEpoch;
+    std::mutex mutex;
+    std::vector<EpochParticipant*> participants;
+    // retired by participants that are already destroyed
+    std::vector<RetiredPointer> orphans;
+
+    void registerParticipant(EpochParticipant* participant)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        participants.push_back(participant);
+    }
+
+    void unregisterParticipant(EpochParticipant* participant, std::vector<RetiredPointer>& retired)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        participants.erase(std::find(participants.begin(), participants.end(), participant));
+        orphans.insert(orphans.end(), retired.begin(), retired.end());
+    }
+
+    // Advances global epoch if all active participants are in current one
+    // and frees orphans that became safe, returns current epoch
+    uint64_t tryAdvance();
+
+    static size_t freeSafe(std::vector<RetiredPointer>& retired, uint64_t epoch)
+    {
+        // pointers retired in epoch e can be freed in epoch e + 2
+        auto safeEnd = std::stable_partition(retired.begin(), retired.end(), [&](const RetiredPointer& r) {
+            return r.epoch + 2 <= epoch;
+        });
+        size_t freed = static_cast<size_t>(safeEnd - retired.begin());
+        std::for_each(retired.begin(), safeEnd, [](const RetiredPointer& r) { r.deleter(r.pointer); });
+        retired.erase(retired.begin(), safeEnd);
+        return freed;
+    }
+
+    friend struct EpochParticipant;
+};
+
+// Per-thread state: announced epoch and list of retired pointers
+// Must be used by one thread only
+struct EpochParticipant
+{
+    // Retired pointers are collected every RetireBatch retirements
+    static const size_t RetireBatch = 64;
+
+    explicit EpochParticipant(EpochManager& m) :manager(m), state(0) { manager.registerParticipant(this); }
+    ~EpochParticipant()
+    {
+        collect();
+        manager.unregisterParticipant(this, retired);
+    }
+
+    // Starts critical section, calls can not be nested
+    // Shared structure has to be entered with seq_cst load (after enter)
+    // and updated with seq_cst store (before retire), so the announcement
+    // is ordered with both
+    void enter() { state.store((manager.globalEpoch.load() << 1) | 1); }
+    // Ends critical section
+    void exit() { state.store(0); }
+
+    // Defers deleter(pointer) until no reader can reach pointer
+    // Pointer has to be unreachable for new readers already
+    void retire(void* pointer, void (*deleter)(void*))
+    {
+        retired.push_back(RetiredPointer{ pointer, deleter, manager.globalEpoch.load() });
+        if (retired.size() % RetireBatch == 0) collect();
+    }
+
+    void retireCell(ListCell* cell)
+    {
+        retire(cell, [](void* p) { freeCell(static_cast<ListCell*>(p)); });
+    }
+
+    // Node is released with releaseNode
+    void retireNode(Node* node)
+    {
+        retire(node, [](void* p) { releaseNode(static_cast<Node*>(p)); });
+    }
+
+    // Tries to advance epoch and frees retired pointers that are safe
+    // Returns number of freed pointers
+    size_t collect()
+    {
+        return EpochManager::freeSafe(retired, manager.tryAdvance());
+    }
+
+    size_t pending() const { return retired.size(); }
+
+private:
+    EpochParticipant(const EpochParticipant&);
+    EpochParticipant& operator=(const EpochParticipant&);
+
+    EpochManager& manager;
+    // (epoch << 1) | 1 inside critical section, 0 outside
+    std::atomic<uint64_t> state;
+    std::vector<RetiredPointer> retired;
+
+    friend struct EpochManager;
+};
+
+uint64_t EpochManager::tryAdvance()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t current = globalEpoch.load();
+    bool allCurrent = std::all_of(participants.begin(), participants.end(), [&](const EpochParticipant* p) {
+        uint64_t state = p->state.load();
+        return !(state & 1) || (state >> 1) == current;
+    });
+    if (allCurrent) globalEpoch.store(++current);
+    freeSafe(orphans, current);
+    return current;
+}
+
+// RAII critical section of a reader
+struct EpochGuard
+{
+    explicit EpochGuard(EpochParticipant& p) :participant(p) { participant.enter(); }
+    ~EpochGuard() { participant.exit(); }
+private:
+    EpochGuard(const EpochGuard&);
+    EpochGuard& operator=(const EpochGuard&);
+    EpochParticipant& participant;
+};
+
+#endif
@@ -0,0 +1,331 @@
+#ifndef FLAT_LIST_H
+#define FLAT_LIST_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <deque>
+#include "list_tools.h"
+
+// Flat (relocatable) List layout
+// A List of Idents, nested Lists or ints can be written into one
+// contiguous block of bytes and used directly from there,
+// for instance after mapping a file into memory.
+// There are no pointers inside the block, every reference
+// is an int32 offset relative to the structure that holds it
+// and names are stored inline after FlatIdent,
+// so the block can be moved or mapped at any address.
+// Offset 0 means "no element" (nullptr).
+
+const uint32_t FlatListMagic = 0x46475053; // "SPGF"
+const uint16_t FlatListVersion = 1;
+
+struct FlatHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t wcharSize;
+    uint32_t size;
+    int32_t root;      // relative to header
+};
+
+// Every flat node starts with NodeTag, the same way Node does
+struct FlatNode
+{
+    int32_t type;
+};
+
+struct FlatCell
+{
+    int32_t data;      // relative node offset or int value for T_IntList
+    int32_t next;      // relative to this cell
+};
+
+struct FlatList
+{
+    int32_t type;      // T_List or T_IntList
+    int32_t length;
+    int32_t head;      // relative to this list
+    int32_t tail;      // relative to this list
+};
+
+// FlatIdent is followed by length + 1 wchar_t (zero terminated name)
+struct FlatIdent
+{
+    int32_t type;      // T_Ident
+    int32_t length;
+};
+
+// Resolves self relative offset
+template<typename DEST>
+const DEST* flatResolve(const void* from, int32_t offset)
+{
+    if (!offset) return nullptr;
+    return reinterpret_cast<const DEST*>(reinterpret_cast<const char*>(from) + offset);
+}
+
+// Returns node stored in a cell of T_List flat list
+const FlatNode* flatCellNode(const FlatCell* cell)
+{
+    return flatResolve<FlatNode>(cell, cell->data);
+}
+
+// Returns int stored in a cell of T_IntList flat list
+int flatCellInt(const FlatCell* cell)
+{
+    return cell->data;
+}
+
+// Returns inline name of FlatIdent
+const wchar_t* flatIdentName(const FlatIdent* ident)
+{
+    return reinterpret_cast<const wchar_t*>(ident + 1);
+}
+
+// ForwardIterator for FlatListView
+struct FlatListIterator
+    :public std::iterator<std::forward_iterator_tag, const FlatCell*>
+{
+    explicit FlatListIterator(const FlatCell* cell) :cellPtr(cell) {}
+    const FlatCell* operator*() const { return cellPtr; }
+    bool operator != (const FlatListIterator& rhs) const { return cellPtr != rhs.cellPtr; }
+    bool operator == (const FlatListIterator& rhs) const { return cellPtr == rhs.cellPtr; }
+
+    FlatListIterator& operator++()
+    {
+        cellPtr = flatResolve<FlatCell>(cellPtr, cellPtr->next);
+        return *this;
+    }
+
+    FlatListIterator operator++(int)
+    {
+        FlatListIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+private:
+    const FlatCell* cellPtr;
+};
+
+// Read-only view of a flat list
+// It does not own memory, the block has to outlive the view
+struct FlatListView
+{
+    explicit FlatListView(const FlatList* l) :list(l) {}
+
+    // Validates the block and returns view of its root list
+    // Every offset, length and node tag is checked against the block,
+    // so corrupted input throws std::invalid_argument instead of being
+    // read outside of it
+    static FlatListView fromBuffer(const void* data, size_t size)
+    {
+        if (size < sizeof(FlatHeader))
+            throw std::invalid_argument("flat list: buffer too small");
+        if (reinterpret_cast<uintptr_t>(data) % alignof(FlatHeader))
+            throw std::invalid_argument("flat list: buffer not aligned");
+        auto header = reinterpret_cast<const FlatHeader*>(data);
+        if (header->magic != FlatListMagic || header->version != FlatListVersion)
+            throw std::invalid_argument("flat list: bad magic or version");
+        if (header->wcharSize != sizeof(wchar_t))
+            throw std::invalid_argument("flat list: wchar_t size mismatch");
+        if (header->size > size || header->root < static_cast<int32_t>(sizeof(FlatHeader))
+            || static_cast<uint32_t>(header->root) + sizeof(FlatList) > header->size)
+            throw std::invalid_argument("flat list: corrupted header");
+        validate(header);
+        return FlatListView(flatResolve<FlatList>(header, header->root));
+    }
+
+    int length() const { return list->length; }
+    NodeTag type() const { return static_cast<NodeTag>(list->type); }
+    const FlatCell* head() const { return flatResolve<FlatCell>(list, list->head); }
+    const FlatCell* tail() const { return flatResolve<FlatCell>(list, list->tail); }
+
+private:
+    const FlatList* list;
+
+    // Walks all lists of the block checking that every structure
+    // lies inside of it
+    static void validate(const FlatHeader* header)
+    {
+        const char* base = reinterpret_cast<const char*>(header);
+        // position of structure of given size referenced by offset from position from, -1 if it is outside
+        auto resolve = [&](size_t from, int32_t offset, size_t size) -> int64_t {
+            int64_t pos = static_cast<int64_t>(from) + offset;
+            if (pos < static_cast<int64_t>(sizeof(FlatHeader)) || pos % 4 || static_cast<uint64_t>(pos) + size > header->size)
+                return -1;
+            return pos;
+        };
+        auto fail = []() { throw std::invalid_argument("flat list: corrupted block"); };
+
+        // every cell is visited once, more cells than fit in the block means a cycle
+        size_t cellBudget = header->size / sizeof(FlatCell);
+        std::vector<size_t> pending(1, static_cast<size_t>(header->root));
+        while (!pending.empty()) {
+            size_t listPos = pending.back();
+            pending.pop_back();
+            FlatList list;
+            memcpy(&list, base + listPos, sizeof(list));
+            if ((list.type != T_List && list.type != T_IntList) || list.length < 0) fail();
+            if (!list.length) {
+                if (list.head || list.tail) fail();
+                continue;
+            }
+            int64_t cellPos = resolve(listPos, list.head, sizeof(FlatCell));
+            int64_t tailPos = resolve(listPos, list.tail, sizeof(FlatCell));
+            if (!list.head || cellPos < 0 || tailPos < 0) fail();
+            for (int32_t i = 0; i < list.length; ++i) {
+                if (cellPos < 0 || !cellBudget--) fail();
+                FlatCell cell;
+                memcpy(&cell, base + cellPos, sizeof(cell));
+                if (list.type == T_List) {
+                    int64_t nodePos = resolve(static_cast<size_t>(cellPos), cell.data, sizeof(FlatIdent));
+                    if (!cell.data || nodePos < 0) fail();
+                    FlatNode node;
+                    memcpy(&node, base + nodePos, sizeof(node));
+                    if (node.type == T_Ident) {
+                        FlatIdent ident;
+                        memcpy(&ident, base + nodePos, sizeof(ident));
+                        if (ident.length < 0 || static_cast<uint64_t>(nodePos) + sizeof(FlatIdent)
+                            + sizeof(wchar_t) * (static_cast<uint64_t>(ident.length) + 1) > header->size) fail();
+                        wchar_t terminator;
+                        memcpy(&terminator, base + nodePos + sizeof(FlatIdent) + sizeof(wchar_t) * static_cast<size_t>(ident.length), sizeof(terminator));
+                        if (terminator) fail();
+                    } else if (node.type == T_List || node.type == T_IntList) {
+                        if (resolve(static_cast<size_t>(cellPos), cell.data, sizeof(FlatList)) < 0) fail();
+                        pending.push_back(static_cast<size_t>(nodePos));
+                    } else {
+                        fail();
+                    }
+                }
+                bool last = i + 1 == list.length;
+                if (last != !cell.next || (last && cellPos != tailPos)) fail();
+                if (!last) cellPos = resolve(static_cast<size_t>(cellPos), cell.next, sizeof(FlatCell));
+            }
+        }
+    }
+};
+
+// Returns view of nested list stored in a cell
+FlatListView flatCellList(const FlatCell* cell)
+{
+    return FlatListView(reinterpret_cast<const FlatList*>(flatCellNode(cell)));
+}
+
+// Returns flat list head
+FlatListIterator begin(const FlatListView& list) { return FlatListIterator(list.head()); }
+// Returns flat list end
+FlatListIterator end(const FlatListView&) { return FlatListIterator(nullptr); }
+
+// Writes List into a relocatable block of bytes
+// Supported elements : Ident and nested List nodes in T_List
+// and int values in T_IntList
+// Throws std::length_error if the block would not fit int32 offsets
+std::vector<char> flattenList(const List& root)
+{
+    std::vector<char> buffer(sizeof(FlatHeader));
+
+    auto reserve = [&](size_t size) {
+        size_t pos = buffer.size();
+        // keep every structure 4 bytes aligned
+        size_t aligned = (size + 3) & ~size_t(3);
+        if (aligned > static_cast<size_t>(INT32_MAX) - pos) throw std::length_error("flattenList: block exceeds 2 GB");
+        buffer.resize(pos + aligned);
+        return pos;
+    };
+    auto relative = [](size_t from, size_t to) {
+        return static_cast<int32_t>(static_cast<int64_t>(to) - static_cast<int64_t>(from));
+    };
+
+    // pending lists and position of their FlatList structure
+    std::deque<std::pair<const List*, size_t>> pending;
+    pending.emplace_back(&root, reserve(sizeof(FlatList)));
+
+    while (!pending.empty()) {
+        const List* list = pending.front().first;
+        size_t listPos = pending.front().second;
+        pending.pop_front();
+
+        FlatList flat;
+        flat.type = list->type;
+        flat.length = list->length;
+        flat.head = 0;
+        flat.tail = 0;
+
+        size_t cellsPos = reserve(sizeof(FlatCell) * list->length);
+        size_t cellPos = cellsPos;
+        for (auto cell : *list) {
+            FlatCell flatCell;
+            flatCell.next = cell->next ? static_cast<int32_t>(sizeof(FlatCell)) : 0;
+            if (list->type == T_IntList) {
+                flatCell.data = cell->data.int_value;
+            }
+            else {
+                const Node* node = castNode<Node>(cell);
+                size_t nodePos;
+                if (node->type == T_Ident || node->type == T_IdentView || node->type == T_IdentEncoded) {
+                    // name is copied in place, terminator comes from resize
+                    size_t nameLength = identWideLength(node);
+                    nodePos = reserve(sizeof(FlatIdent) + sizeof(wchar_t) * (nameLength + 1));
+                    FlatIdent flatIdent;
+                    flatIdent.type = T_Ident;
+                    flatIdent.length = static_cast<int32_t>(nameLength);
+                    memcpy(&buffer[nodePos], &flatIdent, sizeof(flatIdent));
+                    copyIdentWideName(node, &buffer[nodePos + sizeof(flatIdent)]);
+                }
+                else if (node->type == T_List || node->type == T_IntList) {
+                    nodePos = reserve(sizeof(FlatList));
+                    pending.emplace_back(static_cast<const List*>(node), nodePos);
+                }
+                else {
+                    throw std::invalid_argument("flattenList: unsupported node tag");
+                }
+                flatCell.data = relative(cellPos, nodePos);
+            }
+            memcpy(&buffer[cellPos], &flatCell, sizeof(flatCell));
+            cellPos += sizeof(FlatCell);
+        }
+        if (list->length) {
+            flat.head = relative(listPos, cellsPos);
+            flat.tail = relative(listPos, cellPos - sizeof(FlatCell));
+        }
+        memcpy(&buffer[listPos], &flat, sizeof(flat));
+    }
+
+    FlatHeader header;
+    header.magic = FlatListMagic;
+    header.version = FlatListVersion;
+    header.wcharSize = sizeof(wchar_t);
+    header.size = static_cast<uint32_t>(buffer.size());
+    header.root = sizeof(FlatHeader);
+    memcpy(&buffer[0], &header, sizeof(header));
+    return buffer;
+}
+
+// ListNodeTrait implementation for FlatListView
+// reverse() is not provided as view is read-only
+// so only reverse_impl_1 - reverse_impl_3 can be used
+// Elements other than Idents (nested lists) throw std::invalid_argument
+template<>
+struct ListNodeTrait<FlatListView>
+{
+    typedef const FlatCell* node;
+    typedef FlatListIterator iterator;
+
+    static iterator begin(const FlatListView& list) { return ::begin(list); }
+    static iterator end(const FlatListView& list) { return ::end(list); }
+
+    static void appendElement(const FlatCell* node, bool& firstElement, std::wstring& result)
+    {
+        const FlatNode* element = flatCellNode(node);
+        if (element->type != T_Ident) throw std::invalid_argument("FlatListView: only Idents can be rendered");
+        if (!firstElement) result.append(L".");
+        auto ident = reinterpret_cast<const FlatIdent*>(element);
+        result.append(flatIdentName(ident), ident->length);
+        firstElement = false;
+    }
+};
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef IDENT_ENCODING_H
+#define IDENT_ENCODING_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include "pg/nodes.h"
+
+// Compact storage of identifier names (T_IdentEncoded)
+// wchar_t takes 4 bytes on Linux, while most names are ASCII.
+// IdentEncoded keeps its name in a chunk next to the node, one byte per
+// character for ASCII names, and UTF-8 or UTF-16 for the other ones.
+// Names are accessed by code points (forEachIdentCodePoint) or rendered
+// to wide or UTF-8 strings (see appendIdentName in list_tools.h).
+// Encoded Idents are created only by makeIdentEncoded, makeIdent always
+// creates Ident with wchar_t name (IdentExt).
+
+// Storage of non ASCII names of encoded Idents
+enum IdentStorage
+{
+    IdentStorageUtf8,
+    IdentStorageUtf16
+};
+
+enum IdentEncoding : uint8_t
+{
+    IdentEncodingAscii, // one byte per character, used for ASCII names in any storage
+    IdentEncodingUtf8,
+    IdentEncodingUtf16
+};
+
+struct IdentEncoded : public Node
+{
+    IdentEncoding encoding;
+    // rendering decisions cached by ident_quoting.h, 0 until computed
+    mutable std::atomic<uint8_t> renderFlags{0};
+    // code units of the name (bytes, or char16_t for UTF-16)
+    uint32_t size;
+    // name, zero terminated, in its own chunk of the same memory context
+    const void* data;
+
+    ~IdentEncoded() { pfree(const_cast<void*>(data), dataSize()); }
+
+    const unsigned char* bytes() const { return static_cast<const unsigned char*>(data); }
+    const char16_t* units() const { return static_cast<const char16_t*>(data); }
+    size_t dataSize() const { return (encoding == IdentEncodingUtf16 ? sizeof(char16_t) : 1) * (size + 1); }
+};
+
+// Reads code point of UTF-8 text, moves bytes after it
+// Throws std::invalid_argument for malformed text
+uint32_t readUtf8(const unsigned char*& bytes, const unsigned char* end)
+{
+    uint32_t codePoint = *bytes++;
+    if (codePoint < 0x80) return codePoint;
+    int continuation = codePoint >= 0xF0 ? 3 : codePoint >= 0xE0 ? 2 : codePoint >= 0xC0 ? 1 : -1;
+    if (continuation < 0 || codePoint >= 0xF8 || end - bytes < continuation) {
+        throw std::invalid_argument("invalid UTF-8");
+    }
+    codePoint &= 0x3Fu >> continuation;
+    for (int i = 0; i < continuation; ++i, ++bytes) {
+        if ((*bytes & 0xC0) != 0x80) throw std::invalid_argument("invalid UTF-8");
+        codePoint = (codePoint << 6) | (*bytes & 0x3Fu);
+    }
+    static const uint32_t minimum[] = { 0, 0x80, 0x800, 0x10000 };
+    if (codePoint < minimum[continuation] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        throw std::invalid_argument("invalid UTF-8");
+    }
+    return codePoint;
+}
+
+// Calls f(codePoint) for every character of UTF-8 text
+// Throws std::invalid_argument for malformed text
+template<typename F>
+void forEachUtf8CodePoint(const unsigned char* bytes, const unsigned char* end, F f)
+{
+    while (bytes < end) f(readUtf8(bytes, end));
+}
+
+// Reads code point of UTF-16 text, moves units after it
+// Unpaired surrogates are returned as they are
+template<typename Unit>
+uint32_t readUtf16(const Unit*& units, const Unit* end)
+{
+    uint32_t codePoint = static_cast<uint32_t>(*units++);
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && units < end && *units >= 0xDC00 && *units <= 0xDFFF) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<uint32_t>(*units++) - 0xDC00);
+    }
+    return codePoint;
+}
+
+// Calls f(codePoint) for every character of UTF-16 text
+// Unpaired surrogates are passed as they are
+template<typename Unit, typename F>
+void forEachUtf16CodePoint(const Unit* units, const Unit* end, F f)
+{
+    while (units < end) f(readUtf16(units, end));
+}
+
+// Calls f(codePoint) for every character of wide text
+template<typename F>
+void forEachWideCodePoint(const wchar_t* text, size_t length, F f)
+{
+    if (sizeof(wchar_t) == 2) {
+        forEachUtf16CodePoint(text, text + length, f);
+    } else {
+        for (size_t i = 0; i < length; ++i) f(static_cast<uint32_t>(text[i]));
+    }
+}
+
+// Number of UTF-8 bytes of code point
+size_t utf8Size(uint32_t codePoint)
+{
+    return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+}
+
+// Writes UTF-8 bytes of code point, returns position after them
+unsigned char* writeUtf8(unsigned char* out, uint32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        *out++ = static_cast<unsigned char>(codePoint);
+    } else if (codePoint < 0x800) {
+        *out++ = static_cast<unsigned char>(0xC0 | (codePoint >> 6));
+        *out++ = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        *out++ = static_cast<unsigned char>(0xE0 | (codePoint >> 12));
+        *out++ = static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+    } else {
+        *out++ = static_cast<unsigned char>(0xF0 | (codePoint >> 18));
+        *out++ = static_cast<unsigned char>(0x80 | ((codePoint >> 12) & 0x3F));
+        *out++ = static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+    }
+    return out;
+}
+
+// Writes code point as wchar_t (surrogate pair if wchar_t is 16 bits wide)
+// Returns position after it
+wchar_t* writeWide(wchar_t* out, uint32_t codePoint)
+{
+    if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF) {
+        *out++ = static_cast<wchar_t>(0xD800 + ((codePoint - 0x10000) >> 10));
+        *out++ = static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+    } else {
+        *out++ = static_cast<wchar_t>(codePoint);
+    }
+    return out;
+}
+
+// Reads code point of wide text (surrogate pair if wchar_t is 16 bits wide)
+// Moves text after it
+uint32_t readWide(const wchar_t*& text, const wchar_t* end)
+{
+    uint32_t codePoint = static_cast<uint32_t>(*text++);
+    if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint <= 0xDBFF && text < end
+        && static_cast<uint32_t>(*text) >= 0xDC00 && static_cast<uint32_t>(*text) <= 0xDFFF) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<uint32_t>(*text++) - 0xDC00);
+    }
+    return codePoint;
+}
+
+// Calls f(codePoint) for every character of encoded Ident
+template<typename F>
+void forEachIdentCodePoint(const IdentEncoded* ident, F f)
+{
+    switch (ident->encoding) {
+    case IdentEncodingAscii:
+        for (uint32_t i = 0; i < ident->size; ++i) f(static_cast<uint32_t>(ident->bytes()[i]));
+        break;
+    case IdentEncodingUtf8:
+        forEachUtf8CodePoint(ident->bytes(), ident->bytes() + ident->size, f);
+        break;
+    case IdentEncodingUtf16:
+        forEachUtf16CodePoint(ident->units(), ident->units() + ident->size, f);
+        break;
+    }
+}
+
+// Encoded Ident constructor, name is stored in given storage
+// (ASCII names take one byte per character in any of them)
+// Throws std::invalid_argument if name is not valid Unicode (unpaired
+// surrogate or code point above U+10FFFF), it could not be read back
+Node* makeIdentEncoded(const wchar_t* name, size_t length, IdentStorage storage)
+{
+    size_t units = 0;
+    bool ascii = true;
+    forEachWideCodePoint(name, length, [&](uint32_t codePoint) {
+        if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+            throw std::invalid_argument("makeIdentEncoded: invalid code point in name");
+        }
+        ascii = ascii && codePoint < 0x80;
+        units += storage == IdentStorageUtf8 ? utf8Size(codePoint) : (codePoint > 0xFFFF ? 2 : 1);
+    });
+    auto ident = std::make_unique<IdentEncoded>();
+    ident->type = T_IdentEncoded;
+    ident->encoding = ascii ? IdentEncodingAscii : storage == IdentStorageUtf8 ? IdentEncodingUtf8 : IdentEncodingUtf16;
+    ident->size = static_cast<uint32_t>(units);
+    // name is zero terminated for debugging
+    ident->data = palloc(ident->dataSize());
+    if (ascii) {
+        auto out = const_cast<unsigned char*>(ident->bytes());
+        for (size_t i = 0; i < length; ++i) out[i] = static_cast<unsigned char>(name[i]);
+        out[length] = 0;
+    } else if (storage == IdentStorageUtf8) {
+        auto out = const_cast<unsigned char*>(ident->bytes());
+        forEachWideCodePoint(name, length, [&](uint32_t codePoint) { out = writeUtf8(out, codePoint); });
+        *out = 0;
+    } else {
+        auto out = const_cast<char16_t*>(ident->units());
+        forEachWideCodePoint(name, length, [&](uint32_t codePoint) {
+            if (codePoint > 0xFFFF) {
+                *out++ = static_cast<char16_t>(0xD800 + ((codePoint - 0x10000) >> 10));
+                *out++ = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+            } else {
+                *out++ = static_cast<char16_t>(codePoint);
+            }
+        });
+        *out = 0;
+    }
+    return ident.release();
+}
+
+Node* makeIdentEncoded(const std::wstring& name, IdentStorage storage)
+{
+    return makeIdentEncoded(name.c_str(), name.size(), storage);
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef IDENT_QUOTING_H
+#define IDENT_QUOTING_H
+
+#include <string>
+#include "list_tools.h"
+#include "sql_keywords.h"
+#include "utf8_render.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define IDENT_QUOTING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// SQL-safe rendering of Idents
+// Rendering mode is a combination of flags:
+//     RenderQuoted - name is put in double quotes when needed:
+//                    it is empty, contains anything but a-z, 0-9, _,
+//                    starts with a digit or is a keyword,
+//                    quotes inside are doubled
+//     RenderFolded - name is folded to lower case (A-Z only), for names
+//                    that come from unquoted text; folded name is checked
+//                    for quoting. Names that were quoted in source text
+//                    (RenderFlagSourceQuoted, set by parsers) are kept
+//                    as they are.
+// Names are classified once, the decision is cached in renderFlags of
+// the Ident (IdentExt, IdentView, IdentEncoded), so every following
+// rendering only reads it. Plain PG Ident has no place for the cache,
+// its name is classified on every rendering.
+// Lists are rendered in given mode through RenderView:
+//     reverse_impl_1(renderView<RenderQuoted>(list))
+
+enum IdentRenderMode
+{
+    RenderRaw = 0,
+    RenderQuoted = 1,
+    RenderFolded = 2
+};
+
+// Bits of renderFlags computed on first rendering
+// (RenderFlagSourceQuoted is defined in list_tools.h)
+const uint8_t RenderFlagsComputed = 1;
+const uint8_t RenderFlagQuoteRaw = 2;       // quoting needed for name as it is
+const uint8_t RenderFlagQuoteFolded = 4;    // quoting needed for folded name
+
+// Character classes found in a name
+struct IdentCharClasses
+{
+    bool upper;     // A-Z
+    bool unsafe;    // anything but a-z, A-Z, 0-9, _
+};
+
+#ifdef IDENT_QUOTING_SSE2
+// Lane operations for characters of given size, comparisons are signed,
+// so characters above signed range never fall into a-z, A-Z, 0-9
+template<size_t CharSize>
+struct SimdCharRange;
+
+template<>
+struct SimdCharRange<1>
+{
+    static __m128i broadcast(int c) { return _mm_set1_epi8(static_cast<char>(c)); }
+    static __m128i greater(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+};
+
+template<>
+struct SimdCharRange<2>
+{
+    static __m128i broadcast(int c) { return _mm_set1_epi16(static_cast<short>(c)); }
+    static __m128i greater(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+};
+
+template<>
+struct SimdCharRange<4>
+{
+    static __m128i broadcast(int c) { return _mm_set1_epi32(c); }
+    static __m128i greater(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+};
+
+// Lanes of chars in [low, high]
+template<typename Range>
+__m128i inRange(__m128i chars, int low, int high)
+{
+    return _mm_and_si128(Range::greater(chars, Range::broadcast(low - 1)), Range::greater(Range::broadcast(high + 1), chars));
+}
+#endif
+
+// Classifies characters of a name, 16 bytes at a time with SSE2
+template<typename Char>
+IdentCharClasses classifyIdentChars(const Char* text, size_t length)
+{
+    IdentCharClasses classes = { false, false };
+    size_t i = 0;
+#ifdef IDENT_QUOTING_SSE2
+    typedef SimdCharRange<sizeof(Char)> Range;
+    const size_t lanes = 16 / sizeof(Char);
+    __m128i upper = _mm_setzero_si128();
+    __m128i unsafe = _mm_setzero_si128();
+    for (; i + lanes <= length; i += lanes) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i isUpper = inRange<Range>(chars, 'A', 'Z');
+        __m128i isSafe = _mm_or_si128(_mm_or_si128(inRange<Range>(chars, 'a', 'z'), inRange<Range>(chars, '0', '9')),
+            Range::equal(chars, Range::broadcast('_')));
+        upper = _mm_or_si128(upper, isUpper);
+        // unsafe lanes are neither safe nor upper
+        unsafe = _mm_or_si128(unsafe, _mm_andnot_si128(_mm_or_si128(isSafe, isUpper), _mm_set1_epi8(-1)));
+    }
+    classes.upper = _mm_movemask_epi8(upper) != 0;
+    classes.unsafe = _mm_movemask_epi8(unsafe) != 0;
+#endif
+    for (; i < length; ++i) {
+        uint32_t c = static_cast<uint32_t>(text[i]);
+        if (c >= 'A' && c <= 'Z') classes.upper = true;
+        else if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_')) classes.unsafe = true;
+    }
+    return classes;
+}
+
+// Computes renderFlags of a name
+template<typename Char>
+uint8_t computeRenderFlags(const Char* text, size_t length)
+{
+    IdentCharClasses classes = classifyIdentChars(text, length);
+    // keyword lookup folds the name itself
+    bool quoteFolded = length == 0 || classes.unsafe || (text[0] >= Char('0') && text[0] <= Char('9'))
+        || isSqlKeyword(text, length);
+    bool quoteRaw = quoteFolded || classes.upper;
+    return static_cast<uint8_t>(RenderFlagsComputed | (quoteRaw ? RenderFlagQuoteRaw : 0) | (quoteFolded ? RenderFlagQuoteFolded : 0));
+}
+
+// Returns renderFlags of Ident of any flavour, computes them on first use
+uint8_t identRenderFlags(const Node* node)
+{
+    std::atomic<uint8_t>* cache = identRenderFlagsPtr(node);
+    uint8_t flags = cache ? cache->load(std::memory_order_relaxed) : 0;
+    if (flags & RenderFlagsComputed) return flags;
+
+    if (node->type == T_IdentEncoded) {
+        auto ident = static_cast<const IdentEncoded*>(node);
+        // non ASCII characters always need quoting
+        flags = ident->encoding == IdentEncodingAscii ? computeRenderFlags(ident->bytes(), ident->size)
+            : static_cast<uint8_t>(RenderFlagsComputed | RenderFlagQuoteRaw | RenderFlagQuoteFolded);
+    } else {
+        IdentName name = identName(node);
+        flags = computeRenderFlags(name.data, name.length);
+    }
+    if (!cache) return flags;
+    // concurrent readers compute the same value, source bit is kept
+    return static_cast<uint8_t>(cache->fetch_or(flags, std::memory_order_relaxed) | flags);
+}
+
+// Checks if name of Ident is folded when rendered in given mode
+bool identIsFolded(const Node* node, unsigned mode)
+{
+    return (mode & RenderFolded) && !(identRenderFlags(node) & RenderFlagSourceQuoted);
+}
+
+// Checks if Ident needs quoting when rendered in given mode
+bool identNeedsQuoting(const Node* node, unsigned mode)
+{
+    if (!(mode & RenderQuoted)) return false;
+    return (identRenderFlags(node) & (identIsFolded(node, mode) ? RenderFlagQuoteFolded : RenderFlagQuoteRaw)) != 0;
+}
+
+// Applies mode to name appended to result at position start
+template<typename String>
+void applyRenderMode(const Node* node, unsigned mode, String& result, size_t start)
+{
+    typedef typename String::value_type Char;
+    if (identIsFolded(node, mode)) {
+        for (size_t i = start; i < result.size(); ++i) {
+            if (result[i] >= Char('A') && result[i] <= Char('Z')) result[i] = static_cast<Char>(result[i] + ('a' - 'A'));
+        }
+    }
+    if (!identNeedsQuoting(node, mode)) return;
+    size_t quotes = static_cast<size_t>(std::count(result.begin() + static_cast<std::ptrdiff_t>(start), result.end(), Char('"')));
+    if (quotes) {
+        String name(result, start);
+        result.resize(start);
+        for (Char c : name) {
+            if (c == Char('"')) result.push_back(c);
+            result.push_back(c);
+        }
+    }
+    result.insert(result.begin() + static_cast<std::ptrdiff_t>(start), Char('"'));
+    result.push_back(Char('"'));
+}
+
+// Appends name of Ident rendered in given mode
+void appendIdentRendered(const Node* node, unsigned mode, std::wstring& result)
+{
+    size_t start = result.size();
+    appendIdentName(node, result);
+    if (mode != RenderRaw) applyRenderMode(node, mode, result, start);
+}
+
+// UTF-8 version of appendIdentRendered
+void appendIdentRenderedUtf8(const Node* node, unsigned mode, std::string& result)
+{
+    size_t start = result.size();
+    appendIdentNameUtf8(node, result);
+    if (mode != RenderRaw) applyRenderMode(node, mode, result, start);
+}
+
+// The same as reverse_impl_utf8 rendering names in given mode
+std::string reverse_impl_utf8(const List& list, unsigned mode)
+{
+    std::vector<const Node*> nodes;
+    nodes.reserve(static_cast<size_t>(list.length));
+    for (auto cell : list) nodes.push_back(castNode<Node>(cell));
+
+    std::string result;
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        if (it != nodes.rbegin()) result.push_back('.');
+        appendIdentRenderedUtf8(*it, mode, result);
+    }
+    return result;
+}
+
+// Read-only view of a container rendered by reverse_impl_* in given mode
+template<typename T, unsigned Mode>
+struct RenderView
+{
+    const T& container;
+};
+
+template<unsigned Mode, typename T>
+RenderView<T, Mode> renderView(const T& container)
+{
+    return RenderView<T, Mode>{ container };
+}
+
+template<typename T, unsigned Mode>
+typename ListNodeTrait<T>::iterator begin(const RenderView<T, Mode>& view) { return ListNodeTrait<T>::begin(view.container); }
+template<typename T, unsigned Mode>
+typename ListNodeTrait<T>::iterator end(const RenderView<T, Mode>& view) { return ListNodeTrait<T>::end(view.container); }
+
+// Node of element of a container
+const Node* elementNode(const ListCell* cell) { return castNode<Node>(cell); }
+const Node* elementNode(const Node* node) { return node; }
+
+template<typename T, unsigned Mode>
+struct ListNodeTrait<RenderView<T, Mode>>
+{
+    typedef typename ListNodeTrait<T>::node node;
+    typedef typename ListNodeTrait<T>::iterator iterator;
+
+    static iterator begin(const RenderView<T, Mode>& view) { return ::begin(view); }
+    static iterator end(const RenderView<T, Mode>& view) { return ::end(view); }
+
+    static void appendElement(node element, bool& firstElement, std::wstring& result)
+    {
+        if (!firstElement) result.append(L".");
+        appendIdentRendered(elementNode(element), Mode, result);
+        firstElement = false;
+    }
+};
+
+#endif
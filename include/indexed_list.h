@@ -0,0 +1,129 @@
+#ifndef INDEXED_LIST_H
+#define INDEXED_LIST_H
+
+#include <atomic>
+#include <vector>
+#include "list_tools.h"
+
+// List with data derived from its contents kept on the side
+// IndexedList wraps a List and builds on first use:
+//     skip index    - every ListSkipStep-th cell, so positional access
+//                     to long lists (nth_cell) is O(ListSkipStep)
+//     rendered name - names of Idents joined with '.' (rendered_name)
+// List itself is not changed in any way, derived data lives in the
+// wrapper only. Mutators of the wrapper drop derived data; while it is
+// used, the list must be changed through it or invalidate() has to be
+// called after every other change.
+// Readers can build derived data concurrently (no mutator may run
+// meanwhile), every member is published with compare-and-swap.
+
+// Lists at least that long get skip index on positional access,
+// every ListSkipStep-th cell is indexed
+const int ListSkipMinLength = 64;
+const int ListSkipStep = 16;
+
+// Order of names in rendered name of list
+enum ListNameOrder
+{
+    ListNameForward = 0,    // as elements of list
+    ListNameReversed = 1    // as rendered by reverse_impl_*
+};
+
+struct IndexedList
+{
+    explicit IndexedList(List& target) :list(target), skipIndex(nullptr)
+    {
+        for (auto& name : renderedName) name.store(nullptr, std::memory_order_relaxed);
+    }
+    ~IndexedList() { invalidate(); }
+
+    // Drops derived data, needed after list was changed directly
+    void invalidate()
+    {
+        delete skipIndex.exchange(nullptr, std::memory_order_acq_rel);
+        for (auto& name : renderedName) delete name.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    template<typename ValueType>
+    void push_back(ValueType value) { invalidate(); ::push_back(list, value); }
+    template<typename ValueType>
+    void push_front(ValueType value) { invalidate(); ::push_front(list, value); }
+    BasicListIterator erase(BasicListIterator& iter) { invalidate(); return ::erase(iter); }
+    void reverse() { invalidate(); ::reverse(list); }
+    void clean() { invalidate(); ::clean(list); }
+    void truncate(int n) { invalidate(); list_truncate(list, n); }
+
+    // Returns cell at position n (counted from 0)
+    // Long lists are indexed on first use, so access is O(ListSkipStep)
+    // until the list is changed
+    ListCell* nth_cell(int n) const
+    {
+        if (n < 0 || n >= list.length) throw std::out_of_range("IndexedList::nth_cell: position out of range");
+        if (n == list.length - 1) return list.tail;
+        ListCell* cell = list.head;
+        if (list.length >= ListSkipMinLength && n >= ListSkipStep) {
+            cell = (*index())[static_cast<size_t>(n / ListSkipStep)];
+            n %= ListSkipStep;
+        }
+        while (n--) cell = cell->next;
+        return cell;
+    }
+    Node* nth(int n) const { return castNode<Node>(nth_cell(n)); }
+    int nth_int(int n) const { return nth_cell(n)->data.int_value; }
+
+    // Returns names of Idents of list joined with '.'
+    // Rendering is built on first use and owned by the wrapper, repeated
+    // calls return the same pointer. It is valid until the next mutator
+    // of the wrapper, invalidate() or destruction of the wrapper, and it
+    // is not updated by anything else: after a direct change of the list
+    // or renaming an Ident in place it is stale until invalidate().
+    const std::wstring* rendered_name(ListNameOrder order = ListNameReversed) const
+    {
+        if (auto published = renderedName[order].load(std::memory_order_acquire)) return published;
+        std::vector<const Node*> nodes;
+        nodes.reserve(static_cast<size_t>(list.length));
+        for (ListCell* cell = list.head; cell; cell = cell->next) nodes.push_back(castNode<Node>(cell));
+        if (order == ListNameReversed) std::reverse(nodes.begin(), nodes.end());
+        auto name = new std::wstring();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (i) name->push_back(L'.');
+            appendIdentName(nodes[i], *name);
+        }
+        return publish(renderedName[order], name);
+    }
+
+    const List& get() const { return list; }
+
+private:
+    IndexedList(const IndexedList&);
+    IndexedList& operator=(const IndexedList&);
+
+    // Returns skip index, builds it if needed
+    const std::vector<ListCell*>* index() const
+    {
+        if (auto published = skipIndex.load(std::memory_order_acquire)) return published;
+        auto built = new std::vector<ListCell*>();
+        built->reserve(static_cast<size_t>(list.length / ListSkipStep + 1));
+        int position = 0;
+        for (ListCell* cell = list.head; cell; cell = cell->next, ++position) {
+            if (position % ListSkipStep == 0) built->push_back(cell);
+        }
+        return publish(skipIndex, built);
+    }
+
+    // Publishes value built by reader, first published value wins
+    template<typename T>
+    static const T* publish(std::atomic<const T*>& member, const T* value)
+    {
+        const T* published = nullptr;
+        if (member.compare_exchange_strong(published, value, std::memory_order_acq_rel)) return value;
+        delete value;
+        return published;
+    }
+
+    List& list;
+    mutable std::atomic<const std::vector<ListCell*>*> skipIndex;
+    mutable std::atomic<const std::wstring*> renderedName[2];
+};
+
+#endif
@@ -1,359 +1,1064 @@
-#ifndef LIST_TOOLS_H
-#define LIST_TOOLS_H
-
-#include <iostream>
-#include <memory>
-#include <algorithm>
-#include <wchar.h>
-#include <cstring>
-#include "list_node_trait.h"
-#include <list>
-
-#include "pg/pg_list.h"
-
-// Casts ListCell to specific Node* type
-// example cast to Ident : castNode<Ident>(cell)
-template<typename DEST>
-DEST* castNode(const ListCell* cell)
-{
-    return reinterpret_cast<DEST*>(cell->data.ptr_value);
-}
-
-// IdentExt structure is an extension 
-// to Ident type to provide destructor
-// that will release name 
-struct IdentExt : public Ident
-{
-    ~IdentExt() { delete[] name; }
-};
-
-// List can contain void* or int values
-// To choose to which union field it should be assigned to
-// below type has been provided 
-// Specific specializations do the work
-// It will not compile if there will be choosen different type
-template<typename T>
-struct AssignemntTypeChooser
-{
-    static T* assign(T* type, int value)
-    {
-        static_assert(std::is_integral<T>::value || std::is_same<T, Node>::value, "Unsupported type");
-    }
-};
-
-// Provides choosing data.int_value and assignment to int value
-template<>
-struct AssignemntTypeChooser<int>
-{
-    static ListCell* assign(ListCell* listCell, int value)
-    {
-        listCell->data.int_value = value;
-        return listCell;
-    }
-};
-
-// Provides choosing data.ptr_value and assignment to Node* 
-template<>
-struct AssignemntTypeChooser<Node*>
-{
-    static ListCell* assign(ListCell* listCell, Node* value)
-    {
-        listCell->data.ptr_value = value;
-        return listCell;
-    }
-};
-
-// Constructor for List container
-List makeList()
-{
-    List list;
-    list.head = nullptr;
-    list.length = 0;
-    list.tail = nullptr;
-    list.type = T_List;
-    return list;
-}
-
-// Returns list length
-int getListSize(const List& list)
-{
-    return const_cast<List&>(list).length;
-}
-
-// Ident(Ext) constructor 
-Node* makeIdent(const std::basic_string<wchar_t>& name)
-{
-    auto node = std::make_unique<IdentExt>();
-    node->type = T_Ident;
-    std::unique_ptr<wchar_t[]> wchar_buf (new wchar_t[name.size() + 1]);
-    memset(wchar_buf.get(), 0, sizeof(wchar_t) * (name.size()+1));
-    node->name = wchar_buf.release();
-    #ifdef __GNUC__
-    wcsncpy(const_cast<wchar_t*>(node->name), name.c_str(), name.size());    
-    #else
-    wcsncpy_s(const_cast<wchar_t*>(node->name), name.size() + 1, name.c_str(), name.size());
-    #endif
-    return node.release();
-
-}
-
-// Insert element to List at the end
-template<typename ValueType>
-void push_back(List& list, ValueType value)
-{    
-    // for now type choosing is based on SFINAE
-    auto cellPtr = AssignemntTypeChooser<ValueType>::assign(std::make_unique<ListCell>().release(), value);
-
-    auto tail = list.tail;
-
-    if (tail) tail->next = cellPtr;    
-    else list.head = cellPtr;
-    
-    list.tail = cellPtr;
-    list.length = list.length + 1;
-}
-
-// Insert element to List at the beginning
-template<typename ValueType>
-void push_front(List& list, ValueType value)
-{
-    // for now type choosing is based on SFINAE
-    auto cellPtr = AssignemntTypeChooser<ValueType>::assign(std::make_unique<ListCell>().release(), value);
-
-    auto head = list.head;
-    if (head) {
-        cellPtr->next = head;
-        list.tail = head;
-    }
-    list.head = cellPtr;
-    list.length = list.length + 1;    
-}
-
-// ForwardIterator for List type
-struct BasicListIterator
-    :public std::iterator<std::forward_iterator_tag, ListCell*>
-{
-    BasicListIterator(const List& l) :list(l), nodePtr(l.head){}
-    ListCell* operator*() const { return nodePtr; }
-    bool operator != (const BasicListIterator& rhs) const { return nodePtr != rhs.nodePtr; }
-    bool operator == (const BasicListIterator& rhs) const { return nodePtr == rhs.nodePtr; }
-    
-    BasicListIterator& operator=(BasicListIterator rhs)
-    {
-        std::swap(nodePtr, rhs.nodePtr);
-        return *this;
-    }
-    
-    BasicListIterator& operator++()
-    {
-        nodePtr = nodePtr->next;
-        return *this;
-    }
-    
-    BasicListIterator operator++(int)
-    {
-        BasicListIterator tmp = *this;
-        nodePtr = nodePtr->next;
-        return tmp;
-    }
-    
-private:
-    BasicListIterator(const List& l, ListCell* cell) :list(l), nodePtr(cell) {}
-    const List& list;
-    ListCell* nodePtr;
-    ListCell* getPrevNodePtr(const ListCell* node) {
-        auto current = list.head;
-        ListCell* prev = nullptr;
-        while (current) {
-            if (current == node) break;
-            prev = current;
-            current = current->next;
-        }
-        return prev;
-    }
-    friend BasicListIterator begin(const List& list);
-    friend BasicListIterator end(const List& list);
-    friend BasicListIterator erase(BasicListIterator& iter);
-};
-
-// Returns List head
-BasicListIterator begin(const List& list) { return BasicListIterator(list, list.head);}
-// Returns List end
-BasicListIterator end(const List& list)   { return BasicListIterator(list, nullptr);}
-
-// Removes element pointer by iterator
-BasicListIterator erase(BasicListIterator& iter)
-{
-    auto toDelete = iter.nodePtr;
-    auto prev = iter.getPrevNodePtr(iter.nodePtr);
-    List& tmpList = const_cast<List&>(iter.list);
-    if (toDelete == iter.list.head) {
-        tmpList.head = iter.nodePtr->next;
-    }
-    if (toDelete == iter.list.tail) {
-        tmpList.tail = prev;
-    }
-    if (prev) prev->next = iter.nodePtr->next;      
-    --const_cast<List&>(iter.list).length;
-    BasicListIterator i(iter.list, iter.nodePtr->next);
-    delete toDelete;
-    return i;
-}
-
-// Remove all List elements
-void clean(const List& list)
-{
-    auto current = begin(list);
-    auto e = end(list);
-    while (current != e) {
-        auto i = current++;        
-        erase(i);
-    }    
-}
-
-// Returns a copy of List
-// take a list and clone function as parameter
-template<typename NodeCloneFunction>
-List copy(const List& list, NodeCloneFunction cloneF)
-{
-    List newList = makeList();
-    auto b = begin(list);
-    auto e = end(list);
-
-    std::for_each(b, e, [&](const ListCell* cell) {
-        push_back(newList, cloneF(cell));
-    });
-    return newList;
-}
-
-// Reverse list inplace by direct pointer manipulation
-void reverse(List& list)
-{
-    ListCell* head = list.head;
-    ListCell* tail = list.head;
-    ListCell *prev = nullptr;
-    ListCell *next;
-
-    while (head) {
-        next = head->next;
-        head->next = prev;
-        prev = head;
-        head = next;
-    }
-
-    list.head = prev;
-    list.tail = tail;
-}
-
-typedef std::unique_ptr<List> UniqueListPtr;
-
-// Create a List in head and returns a std::unique_ptr to it
-UniqueListPtr makeListHeap()
-{
-    auto list = UniqueListPtr(new List());
-    list->head = nullptr;
-    list->length = 0;
-    list->tail = nullptr;
-    list->type = T_List;
-    return list;
-}
-
-// Basic RAII List holder
-// cleans List during destruction
-struct ListHolder
-{
-    ListHolder(List& l):list(l) {}
-    ~ListHolder() { clean(list); }
-    List& getList() { return list; }
-private:
-    ListHolder(const ListHolder&);
-    ListHolder& operator=(const ListHolder&);
-    List& list;
-};
-
-// AutoList is a wrapper around a function API 
-// raising abstraction bar
-// It also represents a history of work on this task
-// which started bottom-up, growing with better abstractions 
-// over time
-template<typename T>
-struct AutoList;
-
-template<>
-struct AutoList<int>
-{
-    AutoList() { list = makeList(); }
-    AutoList(const AutoList& rhs) {
-        auto cloneF = [](const ListCell* cell) { return cell->data.int_value;};
-        list = copy(rhs.list, cloneF);
-    }
-    AutoList& operator=(AutoList rhs)
-    {
-        std::swap(list, rhs.list);
-        return *this;
-    }
-    ~AutoList() { ::clean(list); }
-    void push_front(int value) { ::push_front(list, value); }
-    void push_back(int value) { ::push_back(list, value); }
-    void erase(BasicListIterator it) { ::erase(it); }
-    void reverse() { ::reverse(list); }
-    int size() { return ::list_length(&list); }
-    BasicListIterator begin() { return ::begin(list); }
-    BasicListIterator end() { return ::end(list); }
-private:
-    List list;
-};
-
-template<>
-struct AutoList<Node>
-{
-    AutoList(std::function<Node*(const ListCell* cell)> fun):cloneFun(fun) { list = makeList(); }
-    AutoList(const AutoList& rhs) { list = copy(rhs.list, rhs.cloneFun); }
-    AutoList& operator=(AutoList rhs)
-    {
-        std::swap(list, rhs.list);
-        return *this;
-    }
-    ~AutoList() { cleanNodes(); ::clean(list); }
-    void push_front(Node* value) { ::push_front(list, value); }
-    void push_back(Node* value) { ::push_back(list, value); }
-    void erase(BasicListIterator it) { ::erase(it); }
-    void reverse() { ::reverse(list); }
-    int size() { return ::list_length(&list); }
-    BasicListIterator begin() { return ::begin(list); }
-    BasicListIterator end() { return ::end(list); }
-private:
-    List list;
-    std::function<Node*(const ListCell* cell)> cloneFun;
-
-    void cleanNodes()
-    {
-        std::for_each(begin(), end(), [&](const ListCell* cell) {
-            delete castNode<Node>(cell);
-        });
-    }
-
-};
-
-// ListNodeTrait implementation for List type
-// Reverse implementations can work with any type
-// that provides few additional information about type
-template<>
-struct ListNodeTrait<List>
-{
-    typedef ListCell* node;
-    typedef BasicListIterator iterator;
-
-    static iterator begin(const List& list) { return ::begin(list); }
-    static iterator end(const List& list) { return ::end(list); }
-    static void reverse(List& list) { ::reverse(list); }
-
-    static void appendElement(ListCell* node, bool& firstElement, std::wstring& result)
-    {
-        if (!firstElement) result.append(L".");
-        result.append(castNode<Ident>(node)->name);
-        firstElement = false;
-    }
-};
-
-#endif
+#ifndef LIST_TOOLS_H
+#define LIST_TOOLS_H
+
+#include <iostream>
+#include <memory>
+#include <algorithm>
+#include <wchar.h>
+#include <cstring>
+#include "list_node_trait.h"
+#include "ident_encoding.h"
+#include <list>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include <functional>
+
+#include "pg/pg_list.h"
+
+// Casts ListCell to specific Node* type
+// example cast to Ident : castNode<Ident>(cell)
+template<typename DEST>
+DEST* castNode(const ListCell* cell)
+{
+    return reinterpret_cast<DEST*>(cell->data.ptr_value);
+}
+
+// IdentExt structure is an extension 
+// to Ident type to provide destructor
+// that will release name 
+struct IdentExt : public Ident
+{
+    // rendering decisions cached by ident_quoting.h and
+    // RenderFlagSourceQuoted set by parsers, 0 until computed
+    mutable std::atomic<uint8_t> renderFlags{0};
+
+    ~IdentExt() { if (name) pfree(const_cast<wchar_t*>(name), sizeof(wchar_t) * (wcslen(name) + 1)); }
+};
+
+// List can contain void* or int values
+// To choose to which union field it should be assigned to
+// below type has been provided 
+// Specific specializations do the work
+// It will not compile if there will be choosen different type
+template<typename T>
+struct AssignemntTypeChooser
+{
+    static T* assign(T* type, int value)
+    {
+        static_assert(std::is_integral<T>::value || std::is_same<T, Node>::value, "Unsupported type");
+    }
+};
+
+// Provides choosing data.int_value and assignment to int value
+template<>
+struct AssignemntTypeChooser<int>
+{
+    static ListCell* assign(ListCell* listCell, int value)
+    {
+        listCell->data.int_value = value;
+        return listCell;
+    }
+};
+
+// Provides choosing data.ptr_value and assignment to Node* 
+template<>
+struct AssignemntTypeChooser<Node*>
+{
+    static ListCell* assign(ListCell* listCell, Node* value)
+    {
+        listCell->data.ptr_value = value;
+        return listCell;
+    }
+};
+
+// Constructor for List container
+List makeList()
+{
+    List list;
+    list.head = nullptr;
+    list.length = 0;
+    list.tail = nullptr;
+    list.type = T_List;
+    return list;
+}
+
+// Returns list length
+int getListSize(const List& list)
+{
+    return const_cast<List&>(list).length;
+}
+
+// Constructor of IdentExt or type derived from it
+template<typename T>
+Node* makeIdentAs(const std::basic_string<wchar_t>& name)
+{
+    auto node = std::make_unique<T>();
+    node->type = T_Ident;
+    auto wchar_buf = static_cast<wchar_t*>(palloc(sizeof(wchar_t) * (name.size() + 1)));
+    memset(wchar_buf, 0, sizeof(wchar_t) * (name.size()+1));
+    node->name = wchar_buf;
+    #ifdef __GNUC__
+    wcsncpy(const_cast<wchar_t*>(node->name), name.c_str(), name.size());    
+    #else
+    wcsncpy_s(const_cast<wchar_t*>(node->name), name.size() + 1, name.c_str(), name.size());
+    #endif
+    return node.release();
+
+}
+
+// Ident(Ext) constructor 
+// Encoded Idents are created by makeIdentEncoded
+Node* makeIdent(const std::basic_string<wchar_t>& name)
+{
+    return makeIdentAs<IdentExt>(name);
+}
+
+// Non-owning Ident (T_IdentView)
+// name points into buffer owned by someone else (e.g. statement text)
+// and is not zero terminated, length gives its size.
+// IdentView is not an Ident, so it can not be passed where name is read
+// as zero terminated string; name of any Ident flavour is read with identName.
+// Node has to be released before the buffer.
+struct IdentView : public Node
+{
+    // rendering decisions cached by ident_quoting.h, 0 until computed
+    mutable std::atomic<uint8_t> renderFlags{0};
+    const wchar_t* name;
+    size_t length;
+};
+
+// IdentView constructor, name is not copied
+Node* makeIdentView(const wchar_t* name, size_t length)
+{
+    auto node = new IdentView();
+    node->type = T_IdentView;
+    node->name = name;
+    node->length = length;
+    return node;
+}
+
+// Bit of renderFlags of Idents, set by parsers for names written
+// in double quotes (ident_quoting.h does not fold such names)
+const uint8_t RenderFlagSourceQuoted = 8;
+
+// Returns renderFlags of Ident of any flavour, nullptr for T_Ident
+// that is not IdentExt (plain PG Ident created with new Ident has
+// no place for them)
+std::atomic<uint8_t>* identRenderFlagsPtr(const Node* node)
+{
+    if (node->type == T_IdentEncoded) return &static_cast<const IdentEncoded*>(node)->renderFlags;
+    if (node->type == T_IdentView) return &static_cast<const IdentView*>(node)->renderFlags;
+    auto ident = dynamic_cast<const IdentExt*>(node);
+    return ident ? &ident->renderFlags : nullptr;
+}
+
+// Marks Ident as written in double quotes in source text
+// Throws std::invalid_argument for plain PG Ident (see identRenderFlagsPtr)
+void markIdentSourceQuoted(const Node* node)
+{
+    std::atomic<uint8_t>* flags = identRenderFlagsPtr(node);
+    if (!flags) throw std::invalid_argument("markIdentSourceQuoted: Ident has no render flags");
+    flags->fetch_or(RenderFlagSourceQuoted, std::memory_order_relaxed);
+}
+
+// Name of Ident of any flavour
+struct IdentName
+{
+    const wchar_t* data;
+    size_t length;
+
+    std::wstring str() const { return std::wstring(data, length); }
+    bool operator==(const IdentName& rhs) const { return length == rhs.length && wmemcmp(data, rhs.data, length) == 0; }
+    bool operator!=(const IdentName& rhs) const { return !(*this == rhs); }
+};
+
+// Returns name of owning (T_Ident) or non-owning (T_IdentView) Ident
+// Encoded Idents have no wide name, they are read with functions below
+IdentName identName(const Node* node)
+{
+    if (node->type == T_IdentEncoded) throw std::invalid_argument("identName: encoded Ident has no wide name");
+    if (node->type == T_IdentView) {
+        auto view = static_cast<const IdentView*>(node);
+        return IdentName{ view->name, view->length };
+    }
+    auto ident = static_cast<const Ident*>(node);
+    return IdentName{ ident->name, wcslen(ident->name) };
+}
+
+// Calls f(codePoint) for every character of Ident of any flavour
+template<typename F>
+void forEachIdentCodePoint(const Node* node, F f)
+{
+    if (node->type == T_IdentEncoded) {
+        forEachIdentCodePoint(static_cast<const IdentEncoded*>(node), f);
+    } else {
+        IdentName name = identName(node);
+        forEachWideCodePoint(name.data, name.length, f);
+    }
+}
+
+// Appends name of Ident of any flavour
+void appendIdentName(const Node* node, std::wstring& result)
+{
+    if (node->type != T_IdentEncoded) {
+        IdentName name = identName(node);
+        result.append(name.data, name.length);
+        return;
+    }
+    auto ident = static_cast<const IdentEncoded*>(node);
+    if (ident->encoding == IdentEncodingAscii) {
+        result.append(ident->bytes(), ident->bytes() + ident->size);
+        return;
+    }
+    wchar_t buffer[2];
+    forEachIdentCodePoint(ident, [&](uint32_t codePoint) {
+        result.append(buffer, writeWide(buffer, codePoint));
+    });
+}
+
+// Returns name of Ident of any flavour as wide string
+std::wstring identWideName(const Node* node)
+{
+    std::wstring name;
+    appendIdentName(node, name);
+    return name;
+}
+
+// Number of wchar_t of name of Ident of any flavour
+size_t identWideLength(const Node* node)
+{
+    if (node->type != T_IdentEncoded) return identName(node).length;
+    auto ident = static_cast<const IdentEncoded*>(node);
+    if (ident->encoding == IdentEncodingAscii) return ident->size;
+    size_t length = 0;
+    forEachIdentCodePoint(ident, [&](uint32_t codePoint) { length += sizeof(wchar_t) == 2 && codePoint > 0xFFFF ? 2 : 1; });
+    return length;
+}
+
+// Copies name of Ident of any flavour as identWideLength wchar_t
+// (not terminated), out does not have to be aligned
+void copyIdentWideName(const Node* node, void* out)
+{
+    auto bytes = static_cast<char*>(out);
+    if (node->type != T_IdentEncoded) {
+        IdentName name = identName(node);
+        memcpy(bytes, name.data, sizeof(wchar_t) * name.length);
+        return;
+    }
+    forEachIdentCodePoint(static_cast<const IdentEncoded*>(node), [&](uint32_t codePoint) {
+        wchar_t units[2];
+        size_t size = sizeof(wchar_t) * static_cast<size_t>(writeWide(units, codePoint) - units);
+        memcpy(bytes, units, size);
+        bytes += size;
+    });
+}
+
+// Reads code points of name of Ident of any flavour one by one
+struct IdentCodePointReader
+{
+    explicit IdentCodePointReader(const Node* node)
+        :wide(nullptr), wideEnd(nullptr), bytes(nullptr), bytesEnd(nullptr), units(nullptr), unitsEnd(nullptr)
+    {
+        if (node->type != T_IdentEncoded) {
+            IdentName name = identName(node);
+            encoding = IdentEncodingAscii;
+            wide = name.data;
+            wideEnd = name.data + name.length;
+            return;
+        }
+        auto ident = static_cast<const IdentEncoded*>(node);
+        encoding = ident->encoding;
+        if (encoding == IdentEncodingUtf16) {
+            units = ident->units();
+            unitsEnd = units + ident->size;
+        } else {
+            bytes = ident->bytes();
+            bytesEnd = bytes + ident->size;
+        }
+    }
+
+    // Returns false after the last code point
+    bool next(uint32_t& codePoint)
+    {
+        if (wide) {
+            if (wide == wideEnd) return false;
+            codePoint = readWide(wide, wideEnd);
+        } else if (units) {
+            if (units == unitsEnd) return false;
+            codePoint = readUtf16(units, unitsEnd);
+        } else {
+            if (bytes == bytesEnd) return false;
+            codePoint = encoding == IdentEncodingUtf8 ? readUtf8(bytes, bytesEnd) : *bytes++;
+        }
+        return true;
+    }
+
+private:
+    // only one pair is used, wide for not encoded Idents
+    const wchar_t* wide;
+    const wchar_t* wideEnd;
+    const unsigned char* bytes;
+    const unsigned char* bytesEnd;
+    const char16_t* units;
+    const char16_t* unitsEnd;
+    IdentEncoding encoding;
+};
+
+// Compares names of Idents of any flavours, nothing is allocated
+bool identNameEquals(const Node* a, const Node* b)
+{
+    if (a->type != T_IdentEncoded && b->type != T_IdentEncoded) return identName(a) == identName(b);
+    if (a->type == T_IdentEncoded && b->type == T_IdentEncoded) {
+        auto encodedA = static_cast<const IdentEncoded*>(a);
+        auto encodedB = static_cast<const IdentEncoded*>(b);
+        // ASCII names are never stored in other encodings
+        if (encodedA->encoding == encodedB->encoding) {
+            size_t unitSize = encodedA->encoding == IdentEncodingUtf16 ? sizeof(char16_t) : 1;
+            return encodedA->size == encodedB->size && memcmp(encodedA->bytes(), encodedB->bytes(), unitSize * encodedA->size) == 0;
+        }
+    }
+    IdentCodePointReader readerA(a);
+    IdentCodePointReader readerB(b);
+    uint32_t codePointA = 0, codePointB = 0;
+    for (;;) {
+        bool moreA = readerA.next(codePointA);
+        bool moreB = readerB.next(codePointB);
+        if (moreA != moreB || codePointA != codePointB) return false;
+        if (!moreA) return true;
+    }
+}
+
+// FNV-1a hash of a sequence of values (characters, code points, bytes)
+struct Fnv1aHash
+{
+    uint64_t value = 14695981039346656037ULL;
+
+    void add(uint64_t item)
+    {
+        value ^= item;
+        value *= 1099511628211ULL;
+    }
+    void add(const void* data, size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) add(bytes[i]);
+    }
+};
+
+// Hash of name of Ident, the same for all flavours (FNV-1a of code points)
+size_t identNameHash(const Node* node)
+{
+    Fnv1aHash hash;
+    forEachIdentCodePoint(node, [&](uint32_t codePoint) { hash.add(codePoint); });
+    return static_cast<size_t>(hash.value);
+}
+
+// Allocates empty ListCell in current memory context
+ListCell* allocCell()
+{
+    return new ListCell();
+}
+
+// Releases ListCell allocated by allocCell
+void freeCell(ListCell* cell)
+{
+    delete cell;
+}
+
+// Allocates ListCell holding value
+template<typename ValueType>
+ListCell* makeCell(ValueType value)
+{
+    // for now type choosing is based on SFINAE
+    return AssignemntTypeChooser<ValueType>::assign(allocCell(), value);
+}
+
+// Insert element to List at the end
+template<typename ValueType>
+void push_back(List& list, ValueType value)
+{    
+    auto cellPtr = makeCell(value);
+
+    auto tail = list.tail;
+
+    if (tail) tail->next = cellPtr;    
+    else list.head = cellPtr;
+    
+    list.tail = cellPtr;
+    list.length = list.length + 1;
+}
+
+// Insert element to List at the beginning
+template<typename ValueType>
+void push_front(List& list, ValueType value)
+{
+    auto cellPtr = makeCell(value);
+
+    auto head = list.head;
+    if (head) cellPtr->next = head;
+    else list.tail = cellPtr;
+    list.head = cellPtr;
+    list.length = list.length + 1;    
+}
+
+// ForwardIterator for List type
+struct BasicListIterator
+    :public std::iterator<std::forward_iterator_tag, ListCell*>
+{
+    BasicListIterator(const List& l) :list(l), nodePtr(l.head){}
+    ListCell* operator*() const { return nodePtr; }
+    bool operator != (const BasicListIterator& rhs) const { return nodePtr != rhs.nodePtr; }
+    bool operator == (const BasicListIterator& rhs) const { return nodePtr == rhs.nodePtr; }
+    
+    BasicListIterator& operator=(BasicListIterator rhs)
+    {
+        std::swap(nodePtr, rhs.nodePtr);
+        return *this;
+    }
+    
+    BasicListIterator& operator++()
+    {
+        nodePtr = nodePtr->next;
+        return *this;
+    }
+    
+    BasicListIterator operator++(int)
+    {
+        BasicListIterator tmp = *this;
+        nodePtr = nodePtr->next;
+        return tmp;
+    }
+    
+private:
+    BasicListIterator(const List& l, ListCell* cell) :list(l), nodePtr(cell) {}
+    const List& list;
+    ListCell* nodePtr;
+    ListCell* getPrevNodePtr(const ListCell* node) {
+        auto current = list.head;
+        ListCell* prev = nullptr;
+        while (current) {
+            if (current == node) break;
+            prev = current;
+            current = current->next;
+        }
+        return prev;
+    }
+    friend BasicListIterator begin(const List& list);
+    friend BasicListIterator end(const List& list);
+    friend BasicListIterator erase(BasicListIterator& iter);
+};
+
+// Returns List head
+BasicListIterator begin(const List& list) { return BasicListIterator(list, list.head);}
+// Returns List end
+BasicListIterator end(const List& list)   { return BasicListIterator(list, nullptr);}
+
+// Removes element pointer by iterator
+BasicListIterator erase(BasicListIterator& iter)
+{
+    auto toDelete = iter.nodePtr;
+    auto prev = iter.getPrevNodePtr(iter.nodePtr);
+    List& tmpList = const_cast<List&>(iter.list);
+    if (toDelete == iter.list.head) {
+        tmpList.head = iter.nodePtr->next;
+    }
+    if (toDelete == iter.list.tail) {
+        tmpList.tail = prev;
+    }
+    if (prev) prev->next = iter.nodePtr->next;      
+    --const_cast<List&>(iter.list).length;
+    BasicListIterator i(iter.list, iter.nodePtr->next);
+    freeCell(toDelete);
+    return i;
+}
+
+// Remove all List elements
+void clean(const List& list)
+{
+    auto current = begin(list);
+    auto e = end(list);
+    while (current != e) {
+        auto i = current++;        
+        erase(i);
+    }    
+}
+
+// Returns a copy of List
+// take a list and clone function as parameter
+template<typename NodeCloneFunction>
+List copy(const List& list, NodeCloneFunction cloneF)
+{
+    List newList = makeList();
+    auto b = begin(list);
+    auto e = end(list);
+
+    std::for_each(b, e, [&](const ListCell* cell) {
+        push_back(newList, cloneF(cell));
+    });
+    return newList;
+}
+
+// Reverse list inplace by direct pointer manipulation
+void reverse(List& list)
+{
+    ListCell* head = list.head;
+    ListCell* tail = list.head;
+    ListCell *prev = nullptr;
+    ListCell *next;
+
+    while (head) {
+        next = head->next;
+        head->next = prev;
+        prev = head;
+        head = next;
+    }
+
+    list.head = prev;
+    list.tail = tail;
+}
+
+// Moves all elements of other to the end of list in O(1)
+// other becomes empty
+void list_concat(List& list, List& other)
+{
+    if (&list == &other) throw std::invalid_argument("list_concat: list can not be concatenated with itself");
+    if (!other.head) return;
+    if (list.tail) list.tail->next = other.head;
+    else list.head = other.head;
+    list.tail = other.tail;
+    list.length += other.length;
+    other.head = other.tail = nullptr;
+    other.length = 0;
+}
+
+// Appends new cell with the same value as cell
+void appendCellCopy(List& list, const ListCell* cell)
+{
+    ListCell* copy = allocCell();
+    copy->data = cell->data;
+    if (list.tail) list.tail->next = copy;
+    else list.head = copy;
+    list.tail = copy;
+    ++list.length;
+}
+
+// Returns new List with elements of list followed by elements of other
+// Only cells are copied, both lists keep their nodes
+// Result has the type of list (e.g. T_IntList)
+List list_concat_copy(const List& list, const List& other)
+{
+    List result = makeList();
+    result.type = list.type;
+    for (auto source : { &list, &other }) {
+        for (auto cell : *source) appendCellCopy(result, cell);
+    }
+    return result;
+}
+
+// Moves elements from position n on to the returned List
+// list keeps first n elements, returned List has the same type
+List list_split_at(List& list, int n)
+{
+    List rest = makeList();
+    rest.type = list.type;
+    if (n >= list.length) return rest;
+    if (n <= 0) {
+        std::swap(rest.head, list.head);
+        std::swap(rest.tail, list.tail);
+        std::swap(rest.length, list.length);
+        return rest;
+    }
+    ListCell* last = list.head;
+    for (int i = 1; i < n; ++i) last = last->next;
+    rest.head = last->next;
+    rest.tail = list.tail;
+    rest.length = list.length - n;
+    last->next = nullptr;
+    list.tail = last;
+    list.length = n;
+    return rest;
+}
+
+// Keeps first n elements of list, cells of the other ones are freed
+// Nodes are not released
+void list_truncate(List& list, int n)
+{
+    List rest = list_split_at(list, n);
+    for (ListCell* cell = rest.head; cell;) {
+        ListCell* next = cell->next;
+        freeCell(cell);
+        cell = next;
+    }
+}
+
+// Removes first element of list in O(1)
+void list_delete_first(List& list)
+{
+    if (!list.head) return;
+    ListCell* first = list.head;
+    list.head = first->next;
+    if (!list.head) list.tail = nullptr;
+    --list.length;
+    freeCell(first);
+}
+
+// Removes last element of list
+void list_delete_last(List& list)
+{
+    list_truncate(list, list.length - 1);
+}
+
+// Returns cell at position n (counted from 0)
+// Access is O(n), IndexedList (indexed_list.h) indexes long lists
+ListCell* list_nth_cell(const List& list, int n)
+{
+    if (n < 0 || n >= list.length) throw std::out_of_range("list_nth_cell: position out of range");
+    if (n == list.length - 1) return list.tail;
+    ListCell* cell = list.head;
+    while (n--) cell = cell->next;
+    return cell;
+}
+
+// Returns node at position n
+Node* list_nth(const List& list, int n)
+{
+    return castNode<Node>(list_nth_cell(list, n));
+}
+
+// Returns int value at position n
+int list_nth_int(const List& list, int n)
+{
+    return list_nth_cell(list, n)->data.int_value;
+}
+
+// Cuts chain after count cells starting from cell
+// Returns the rest of the chain
+ListCell* detachCells(ListCell* cell, int count)
+{
+    for (int i = 1; cell && i < count; ++i) cell = cell->next;
+    if (!cell) return nullptr;
+    ListCell* rest = cell->next;
+    cell->next = nullptr;
+    return rest;
+}
+
+// Sorts list in place (stable), cells are relinked, nothing is allocated
+// compare(a, b) takes two ListCell* and returns true if a goes before b
+// Bottom-up merge sort: O(n log n) time, O(1) extra space
+template<typename Compare>
+void list_sort(List& list, Compare compare)
+{
+    if (list.length < 2) return;
+    ListCell* head = list.head;
+    ListCell* tail = nullptr;
+    for (int width = 1; width < list.length; width *= 2) {
+        ListCell* remaining = head;
+        head = tail = nullptr;
+        while (remaining) {
+            ListCell* left = remaining;
+            ListCell* right = detachCells(left, width);
+            remaining = detachCells(right, width);
+            // merge runs left and right after tail
+            while (left || right) {
+                ListCell*& source = (!right || (left && !compare(right, left))) ? left : right;
+                if (tail) tail->next = source;
+                else head = source;
+                tail = source;
+                source = source->next;
+            }
+        }
+    }
+    list.head = head;
+    list.tail = tail;
+}
+
+// Sorts int list in place in ascending order (stable)
+// LSD radix sort by bytes relinking cells through 256 buckets: O(n) time
+void list_sort_int(List& list)
+{
+    if (list.length < 2) return;
+    const int Buckets = 256;
+    ListCell* heads[Buckets];
+    ListCell* tails[Buckets];
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        std::fill(heads, heads + Buckets, nullptr);
+        for (ListCell* cell = list.head; cell; cell = cell->next) {
+            // sign bit flipped so negative values go first
+            unsigned key = static_cast<unsigned>(cell->data.int_value) ^ 0x80000000u;
+            unsigned bucket = (key >> shift) & 0xFF;
+            if (heads[bucket]) tails[bucket]->next = cell;
+            else heads[bucket] = cell;
+            tails[bucket] = cell;
+        }
+        ListCell* tail = nullptr;
+        for (int bucket = 0; bucket < Buckets; ++bucket) {
+            if (!heads[bucket]) continue;
+            if (tail) tail->next = heads[bucket];
+            else list.head = heads[bucket];
+            tail = tails[bucket];
+        }
+        tail->next = nullptr;
+        list.tail = tail;
+    }
+}
+
+// Set operations
+// Elements are compared by key policy: pointer (ListPointerKey),
+// int value (ListIntKey) or Ident name (ListIdentNameKey).
+// Membership is checked by linear scan while set is short, long sets
+// switch to open addressing hash table. Results keep order of elements.
+
+// Finalizer of 64-bit MurmurHash3, spreads bits of pointers and ints
+size_t hashMix(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return static_cast<size_t>(value);
+}
+
+struct ListPointerKey
+{
+    size_t hash(const ListCell* cell) const { return hashMix(reinterpret_cast<uintptr_t>(cell->data.ptr_value)); }
+    bool equal(const ListCell* a, const ListCell* b) const { return a->data.ptr_value == b->data.ptr_value; }
+};
+
+struct ListIntKey
+{
+    size_t hash(const ListCell* cell) const { return hashMix(static_cast<uint32_t>(cell->data.int_value)); }
+    bool equal(const ListCell* a, const ListCell* b) const { return a->data.int_value == b->data.int_value; }
+};
+
+struct ListIdentNameKey
+{
+    size_t hash(const ListCell* cell) const { return identNameHash(castNode<Node>(cell)); }
+    bool equal(const ListCell* a, const ListCell* b) const
+    {
+        return identNameEquals(castNode<Node>(a), castNode<Node>(b));
+    }
+};
+
+// Sets larger than that use hash table
+const size_t ListHashMinLength = 16;
+
+// Set of cells with distinct keys, cells are not owned
+template<typename Key>
+struct ListCellSet
+{
+    explicit ListCellSet(Key k = Key()) :key(k) {}
+
+    bool contains(const ListCell* cell) const
+    {
+        if (slots.empty()) {
+            return std::any_of(cells.begin(), cells.end(), [&](const ListCell* member) { return key.equal(member, cell); });
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = key.hash(cell) & mask; slots[i]; i = (i + 1) & mask) {
+            if (key.equal(slots[i], cell)) return true;
+        }
+        return false;
+    }
+
+    // Returns false if cell with the same key is already in the set
+    bool insert(const ListCell* cell)
+    {
+        if (contains(cell)) return false;
+        cells.push_back(cell);
+        if (!slots.empty() && cells.size() * 2 <= slots.size()) place(cell);
+        else if (cells.size() >= ListHashMinLength) rehash();
+        return true;
+    }
+
+private:
+    Key key;
+    // all members, scanned while set is short
+    std::vector<const ListCell*> cells;
+    // open addressing table (linear probing), at most half full
+    std::vector<const ListCell*> slots;
+
+    void place(const ListCell* cell)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = key.hash(cell) & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = cell;
+    }
+
+    void rehash()
+    {
+        size_t size = 2 * ListHashMinLength;
+        while (size < cells.size() * 4) size *= 2;
+        slots.assign(size, nullptr);
+        for (auto cell : cells) place(cell);
+    }
+};
+
+// Returns new List with elements of list followed by elements
+// of other that are not in it yet (duplicates in other are skipped)
+// Results of set operations have the type of list (e.g. T_IntList)
+template<typename Key>
+List list_union(const List& list, const List& other, Key key = Key())
+{
+    List result = makeList();
+    result.type = list.type;
+    ListCellSet<Key> members(key);
+    for (auto cell : list) {
+        members.insert(cell);
+        appendCellCopy(result, cell);
+    }
+    for (auto cell : other) {
+        if (members.insert(cell)) appendCellCopy(result, cell);
+    }
+    return result;
+}
+
+// Returns new List with elements of list that are in other
+template<typename Key>
+List list_intersection(const List& list, const List& other, Key key = Key())
+{
+    List result = makeList();
+    result.type = list.type;
+    ListCellSet<Key> members(key);
+    for (auto cell : other) members.insert(cell);
+    for (auto cell : list) {
+        if (members.contains(cell)) appendCellCopy(result, cell);
+    }
+    return result;
+}
+
+// Returns new List with elements of list that are not in other
+template<typename Key>
+List list_difference(const List& list, const List& other, Key key = Key())
+{
+    List result = makeList();
+    result.type = list.type;
+    ListCellSet<Key> members(key);
+    for (auto cell : other) members.insert(cell);
+    for (auto cell : list) {
+        if (!members.contains(cell)) appendCellCopy(result, cell);
+    }
+    return result;
+}
+
+// Removes in place elements equal to an earlier one
+// removed(cell) is called for every removed cell before it is freed
+// (e.g. to release the node), cells are freed in the same pass
+template<typename Key, typename Removed>
+void list_deduplicate(List& list, Key key, Removed removed)
+{
+    ListCellSet<Key> members(key);
+    ListCell* prev = nullptr;
+    for (ListCell* cell = list.head; cell;) {
+        ListCell* next = cell->next;
+        if (members.insert(cell)) {
+            prev = cell;
+        } else {
+            if (prev) prev->next = next;
+            else list.head = next;
+            --list.length;
+            removed(cell);
+            freeCell(cell);
+        }
+        cell = next;
+    }
+    list.tail = prev;
+}
+
+template<typename Key>
+void list_deduplicate(List& list, Key key = Key())
+{
+    list_deduplicate(list, key, [](ListCell*) {});
+}
+
+typedef std::unique_ptr<List> UniqueListPtr;
+
+// Create a List in head and returns a std::unique_ptr to it
+UniqueListPtr makeListHeap()
+{
+    auto list = UniqueListPtr(new List());
+    list->head = nullptr;
+    list->length = 0;
+    list->tail = nullptr;
+    list->type = T_List;
+    return list;
+}
+
+// Basic RAII List holder
+// cleans List during destruction
+struct ListHolder
+{
+    ListHolder(List& l):list(l) {}
+    ~ListHolder() { clean(list); }
+    List& getList() { return list; }
+private:
+    ListHolder(const ListHolder&);
+    ListHolder& operator=(const ListHolder&);
+    List& list;
+};
+
+// Shared immutable nodes
+// Nodes created by makeSharedIdent / makeSharedList carry an intrusive
+// reference counter, so one node can be referenced by many trees
+// (e.g. rewritten tree shares untouched subtrees with the original one).
+// Shared nodes must not be modified once they are shared.
+// Shared list owns one reference to each of its nodes,
+// so all nodes put into it should be shared as well.
+struct RefCounted
+{
+    RefCounted() :refCount(1) {}
+    std::atomic<int> refCount;
+};
+
+struct SharedIdent : public IdentExt, public RefCounted {};
+struct SharedList : public List, public RefCounted {};
+
+// Shared Ident constructor, returned node has one reference
+Node* makeSharedIdent(const std::basic_string<wchar_t>& name)
+{
+    return makeIdentAs<SharedIdent>(name);
+}
+
+// Shared List constructor, returned list has one reference
+SharedList* makeSharedList()
+{
+    auto list = new SharedList();
+    list->head = nullptr;
+    list->length = 0;
+    list->tail = nullptr;
+    list->type = T_List;
+    return list;
+}
+
+// Reference counter of shared node, nullptr for other nodes
+// Only T_Ident and T_List nodes can be shared, so the tag is checked
+// before the (more expensive) dynamic_cast
+RefCounted* refCounter(Node* node)
+{
+    if (node->type != T_Ident && node->type != T_List) return nullptr;
+    return dynamic_cast<RefCounted*>(node);
+}
+
+bool isSharedNode(const Node* node)
+{
+    return refCounter(const_cast<Node*>(node)) != nullptr;
+}
+
+// Adds reference to shared node
+Node* retainNode(Node* node)
+{
+    auto refCounted = refCounter(node);
+    if (!refCounted) throw std::invalid_argument("retainNode: node is not shared");
+    refCounted->refCount.fetch_add(1, std::memory_order_relaxed);
+    return node;
+}
+
+// Drops reference to shared node, node is deleted with the last one.
+// Node that is not shared has only one owner, it is just deleted.
+// List (shared or plain) releases its nodes when it is deleted.
+void releaseNode(Node* node)
+{
+    std::vector<Node*> pending(1, node);
+    while (!pending.empty()) {
+        Node* current = pending.back();
+        pending.pop_back();
+        auto refCounted = refCounter(current);
+        if (refCounted && refCounted->refCount.fetch_sub(1, std::memory_order_acq_rel) > 1) continue;
+        if (current->type == T_List) {
+            List* list = static_cast<List*>(current);
+            for (auto cell : *list) pending.push_back(castNode<Node>(cell));
+            clean(*list);
+        }
+        delete current;
+    }
+}
+
+// AutoList is a wrapper around a function API 
+// raising abstraction bar
+// It also represents a history of work on this task
+// which started bottom-up, growing with better abstractions 
+// over time
+template<typename T>
+struct AutoList;
+
+template<>
+struct AutoList<int>
+{
+    AutoList() { list = makeList(); }
+    AutoList(const AutoList& rhs) {
+        auto cloneF = [](const ListCell* cell) { return cell->data.int_value;};
+        list = copy(rhs.list, cloneF);
+    }
+    AutoList& operator=(AutoList rhs)
+    {
+        std::swap(list, rhs.list);
+        return *this;
+    }
+    ~AutoList() { ::clean(list); }
+    void push_front(int value) { ::push_front(list, value); }
+    void push_back(int value) { ::push_back(list, value); }
+    void erase(BasicListIterator it) { ::erase(it); }
+    void reverse() { ::reverse(list); }
+    int size() { return ::list_length(&list); }
+    BasicListIterator begin() { return ::begin(list); }
+    BasicListIterator end() { return ::end(list); }
+private:
+    List list;
+};
+
+template<>
+struct AutoList<Node>
+{
+    AutoList(std::function<Node*(const ListCell* cell)> fun):cloneFun(std::move(fun)) { list = makeList(); }
+    AutoList(const AutoList& rhs) { list = copy(rhs.list, rhs.cloneFun); }
+    AutoList& operator=(AutoList rhs)
+    {
+        std::swap(list, rhs.list);
+        return *this;
+    }
+    ~AutoList() { cleanNodes(); ::clean(list); }
+    void push_front(Node* value) { ::push_front(list, value); }
+    void push_back(Node* value) { ::push_back(list, value); }
+    void erase(BasicListIterator it) { ::erase(it); }
+    void reverse() { ::reverse(list); }
+    int size() { return ::list_length(&list); }
+    BasicListIterator begin() { return ::begin(list); }
+    BasicListIterator end() { return ::end(list); }
+private:
+    List list;
+    std::function<Node*(const ListCell* cell)> cloneFun;
+
+    void cleanNodes()
+    {
+        std::for_each(begin(), end(), [&](const ListCell* cell) {
+            releaseNode(castNode<Node>(cell));
+        });
+    }
+
+};
+
+// ListNodeTrait implementation for List type
+// Reverse implementations can work with any type
+// that provides few additional information about type
+template<>
+struct ListNodeTrait<List>
+{
+    typedef ListCell* node;
+    typedef BasicListIterator iterator;
+
+    static iterator begin(const List& list) { return ::begin(list); }
+    static iterator end(const List& list) { return ::end(list); }
+    static void reverse(List& list) { ::reverse(list); }
+
+    static void appendElement(ListCell* node, bool& firstElement, std::wstring& result)
+    {
+        if (!firstElement) result.append(L".");
+        appendIdentName(castNode<Node>(node), result);
+        firstElement = false;
+    }
+};
+
+#endif
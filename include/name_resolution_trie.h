@@ -0,0 +1,261 @@
+#ifndef NAME_RESOLUTION_TRIE_H
+#define NAME_RESOLUTION_TRIE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "qualified_name_compare.h"
+#include "epoch_reclamation.h"
+
+// Resolution of qualified names (Ident lists) against catalog objects
+// Names are Ident lists in reversed order, the most specific part first
+// (column, table, schema, db), as built by parseQualifiedName and
+// rendered back by reverse_impl_*.
+// So the trie is keyed from the last part of the qualified name and
+// partially qualified names are matched as suffixes: (column) or
+// (column, table) find every object whose full name ends with them,
+// NameAmbiguous is reported when there is more than one.
+// Name parts are interned, trie edges are keyed by part ids.
+// Writer thread inserts and erases names and then publishes an immutable
+// snapshot (flat arrays of nodes and edges) through an atomic pointer,
+// the replaced snapshot is retired through epoch-based reclamation
+// (epoch_reclamation.h). Readers take snapshot inside EpochGuard, which
+// is a pair of atomic stores, and resolve names in one walk of the list
+// without locks or allocations: every part is found by hash in the part
+// table (compared in place with Ident of any flavour), then the edge is
+// found by binary search among children of the node.
+
+enum NameResolutionStatus
+{
+    NameNotFound,
+    NameFound,
+    NameAmbiguous
+};
+
+template<typename Value>
+struct NameResolution
+{
+    NameResolutionStatus status;
+    const Value* value;     // resolved object, nullptr unless found
+};
+
+const uint32_t NoNamePart = UINT32_MAX;
+
+// Hash of wide name, the same as identNameHash of Ident with that name
+size_t namePartHash(const wchar_t* name, size_t length)
+{
+    Fnv1aHash hash;
+    forEachWideCodePoint(name, length, [&](uint32_t codePoint) { hash.add(codePoint); });
+    return static_cast<size_t>(hash.value);
+}
+
+// Interned names of parts, id is position of the name
+// Open addressing table of part ids, at most half full
+struct NamePartTable
+{
+    NamePartTable() :mask(0) {}
+
+    void build(const std::vector<std::wstring>& names)
+    {
+        size_t capacity = 16;
+        while (capacity < names.size() * 2) capacity *= 2;
+        mask = capacity - 1;
+        slots.assign(capacity, NoNamePart);
+        offsets.reserve(names.size() + 1);
+        for (uint32_t id = 0; id < names.size(); ++id) {
+            offsets.push_back(static_cast<uint32_t>(chars.size()));
+            chars.insert(chars.end(), names[id].begin(), names[id].end());
+            size_t slot = namePartHash(names[id].data(), names[id].size()) & mask;
+            while (slots[slot] != NoNamePart) slot = (slot + 1) & mask;
+            slots[slot] = id;
+        }
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+    }
+
+    // Returns id of name of Ident of any flavour or NoNamePart
+    uint32_t find(const Node* ident) const
+    {
+        if (slots.empty()) return NoNamePart;
+        for (size_t slot = identNameHash(ident) & mask; slots[slot] != NoNamePart; slot = (slot + 1) & mask) {
+            uint32_t id = slots[slot];
+            if (compareIdentPart(ident, chars.data() + offsets[id], offsets[id + 1] - offsets[id], false) == 0) return id;
+        }
+        return NoNamePart;
+    }
+
+private:
+    std::vector<wchar_t> chars;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> slots;
+    size_t mask;
+};
+
+// Immutable trie of names published by NameResolutionTrie
+template<typename Value>
+struct NameTrieSnapshot
+{
+    // Resolves full or partially qualified name (a suffix of full names)
+    NameResolution<Value> resolve(const List& name) const
+    {
+        NameResolution<Value> result = { NameNotFound, nullptr };
+        if (!name.head || nodes.empty()) return result;
+        const TrieNode* node = &nodes[0];
+        for (const ListCell* cell = name.head; cell; cell = cell->next) {
+            uint32_t part = parts.find(castNode<Node>(cell));
+            if (part == NoNamePart) return result;
+            auto first = edges.begin() + node->firstEdge;
+            auto last = first + node->edgeCount;
+            auto edge = std::lower_bound(first, last, part, [](const TrieEdge& e, uint32_t p) { return e.part < p; });
+            if (edge == last || edge->part != part) return result;
+            node = &nodes[edge->node];
+        }
+        if (node->matches > 1) {
+            result.status = NameAmbiguous;
+        } else {
+            result.status = NameFound;
+            result.value = &values[node->firstMatch];
+        }
+        return result;
+    }
+
+    // Number of names
+    size_t size() const { return values.size(); }
+
+private:
+    template<typename> friend struct NameResolutionTrie;
+
+    struct TrieNode
+    {
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        uint32_t matches;       // names ending in the subtree, counted up to 2
+        uint32_t firstMatch;    // value of one of them
+    };
+
+    struct TrieEdge
+    {
+        uint32_t part;
+        uint32_t node;
+    };
+
+    typedef typename std::map<std::vector<uint32_t>, Value>::const_iterator EntryIterator;
+
+    // Builds node for entries sharing first depth parts (sorted by parts)
+    // Children of a node take consecutive edges
+    uint32_t build(EntryIterator first, EntryIterator last, size_t depth)
+    {
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(TrieNode{ 0, 0, 0, 0 });
+        if (first->first.size() == depth) {
+            nodes[index].matches = 1;
+            nodes[index].firstMatch = static_cast<uint32_t>(values.size());
+            values.push_back(first->second);
+            ++first;
+        }
+        std::vector<EntryIterator> groups;
+        for (auto it = first; it != last; ++it) {
+            if (groups.empty() || groups.back()->first[depth] != it->first[depth]) groups.push_back(it);
+        }
+        groups.push_back(last);
+        uint32_t firstEdge = static_cast<uint32_t>(edges.size());
+        nodes[index].firstEdge = firstEdge;
+        nodes[index].edgeCount = static_cast<uint32_t>(groups.size() - 1);
+        edges.resize(edges.size() + groups.size() - 1);
+        for (size_t i = 0; i + 1 < groups.size(); ++i) {
+            uint32_t child = build(groups[i], groups[i + 1], depth + 1);
+            edges[firstEdge + i] = TrieEdge{ groups[i]->first[depth], child };
+            if (nodes[index].matches == 0) nodes[index].firstMatch = nodes[child].firstMatch;
+            nodes[index].matches = std::min<uint32_t>(2, nodes[index].matches + nodes[child].matches);
+        }
+        return index;
+    }
+
+    NamePartTable parts;
+    std::vector<TrieNode> nodes;
+    std::vector<TrieEdge> edges;
+    std::vector<Value> values;
+};
+
+// Catalog of names updated by one writer thread and resolved by many
+// reader threads; changes become visible to readers on publish
+template<typename Value>
+struct NameResolutionTrie
+{
+    NameResolutionTrie() :published(new NameTrieSnapshot<Value>()) {}
+    // Snapshots retired by publish are freed by their writer participant,
+    // the last one is freed here (no reader may use it anymore)
+    ~NameResolutionTrie() { delete published.load(); }
+
+    // Writer thread only
+    // Adds full name of object, throws std::invalid_argument
+    // for empty or already added name
+    void insert(const List& name, const Value& value)
+    {
+        if (!name.head) throw std::invalid_argument("NameResolutionTrie: empty name");
+        std::vector<uint32_t> key;
+        key.reserve(static_cast<size_t>(name.length));
+        for (auto cell : name) key.push_back(intern(identWideName(castNode<Node>(cell))));
+        if (!entries.emplace(std::move(key), value).second) throw std::invalid_argument("NameResolutionTrie: name already exists");
+    }
+
+    // Writer thread only
+    // Removes full name, returns false if it is not there
+    bool erase(const List& name)
+    {
+        std::vector<uint32_t> key;
+        for (auto cell : name) {
+            auto part = partIds.find(identWideName(castNode<Node>(cell)));
+            if (part == partIds.end()) return false;
+            key.push_back(part->second);
+        }
+        return entries.erase(key) != 0;
+    }
+
+    // Writer thread only
+    // Builds snapshot of current names and makes it visible to readers
+    // Previous snapshot is retired by writer, readers that took it
+    // keep using it until they leave EpochGuard
+    void publish(EpochParticipant& writer)
+    {
+        auto snapshot = std::make_unique<NameTrieSnapshot<Value>>();
+        snapshot->parts.build(partNames);
+        if (!entries.empty()) snapshot->build(entries.begin(), entries.end(), 0);
+        // seq_cst orders it before retire (see EpochParticipant::enter)
+        NameTrieSnapshot<Value>* old = published.exchange(snapshot.release(), std::memory_order_seq_cst);
+        writer.retire(old, [](void* p) { delete static_cast<NameTrieSnapshot<Value>*>(p); });
+    }
+
+    // Any thread, inside EpochGuard of its participant (writer thread
+    // can use the current snapshot without it)
+    // Returns the last published snapshot; it and resolved values are
+    // valid until the guard is left
+    const NameTrieSnapshot<Value>* snapshot() const
+    {
+        // seq_cst orders it after EpochGuard announcement
+        return published.load(std::memory_order_seq_cst);
+    }
+
+private:
+    NameResolutionTrie(const NameResolutionTrie&);
+    NameResolutionTrie& operator=(const NameResolutionTrie&);
+
+    uint32_t intern(const std::wstring& part)
+    {
+        auto it = partIds.emplace(part, static_cast<uint32_t>(partNames.size()));
+        if (it.second) partNames.push_back(part);
+        return it.first->second;
+    }
+
+    std::unordered_map<std::wstring, uint32_t> partIds;
+    std::vector<std::wstring> partNames;
+    // names by part ids, sorted as trie is built
+    std::map<std::vector<uint32_t>, Value> entries;
+    std::atomic<NameTrieSnapshot<Value>*> published;
+};
+
+#endif
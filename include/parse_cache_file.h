@@ -0,0 +1,180 @@
+#ifndef PARSE_CACHE_FILE_H
+#define PARSE_CACHE_FILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include "flat_list.h"
+
+// Persistent parse cache
+// Maps text of T_PrepareStmt / T_ExecuteStmt statements to their
+// parse trees, so trees survive process restart.
+// File is an append-only log, every record contains
+//   ParseCacheRecord, statement text (wchar_t), flat list block (flat_list.h)
+// Flat list layout is used as on-disk node encoding, so loaded
+// tree can be used directly through FlatListView.
+// Index (statement hash -> record offset) is rebuilt on open from record
+// headers only, trees are read lazily on lookup. Every record carries
+// checksum of its text and tree, which is verified on lookup, and the
+// tree block is fully validated by FlatListView::fromBuffer.
+
+const uint32_t ParseCacheRecordMagic = 0x32435053; // "SPC2"
+
+struct ParseCacheRecord
+{
+    uint32_t magic;
+    int32_t kind;        // NodeTag of statement
+    uint64_t hash;       // statementHash of text
+    uint32_t textLength; // in wchar_t
+    uint32_t treeSize;   // in bytes
+    uint64_t checksum;   // recordChecksum of text and tree
+};
+
+// FNV-1a hash of statement text
+uint64_t statementHash(const wchar_t* text, size_t length)
+{
+    Fnv1aHash hash;
+    for (size_t i = 0; i < length; ++i) hash.add(static_cast<uint64_t>(text[i]));
+    return hash.value;
+}
+
+// FNV-1a of bytes of text and tree of a record
+uint64_t recordChecksum(const std::wstring& text, const char* tree, size_t treeSize)
+{
+    Fnv1aHash hash;
+    hash.add(text.data(), sizeof(wchar_t) * text.size());
+    hash.add(tree, treeSize);
+    return hash.value;
+}
+
+struct ParseCacheFile
+{
+    // Opens (or creates) cache file and builds index
+    // Incomplete record at the end (e.g. after crash during append)
+    // is ignored and overwritten by next store
+    explicit ParseCacheFile(const std::string& path)
+    {
+        // create file if it does not exist yet
+        std::ofstream(path, std::ios::binary | std::ios::app);
+        file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+            throw std::runtime_error("parse cache: cannot open " + path);
+
+        file.seekg(0, std::ios::end);
+        std::streamoff fileSize = file.tellg();
+        file.seekg(0);
+        validEnd = 0;
+
+        ParseCacheRecord record;
+        while (validEnd + static_cast<std::streamoff>(sizeof(record)) <= fileSize) {
+            file.seekg(validEnd);
+            if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) break;
+            if (record.magic != ParseCacheRecordMagic) break;
+            std::streamoff recordEnd = validEnd + recordSize(record);
+            if (recordEnd > fileSize) break;
+            index.emplace(record.hash, validEnd);
+            validEnd = recordEnd;
+        }
+        file.clear();
+    }
+
+    // Appends parse tree of a statement
+    // Returns false if statement is already stored
+    bool store(NodeTag kind, const std::wstring& text, const List& tree)
+    {
+        checkKind(kind);
+        if (find(kind, text) >= 0) return false;
+
+        auto block = flattenList(tree);
+        ParseCacheRecord record;
+        record.magic = ParseCacheRecordMagic;
+        record.kind = kind;
+        record.hash = statementHash(text.data(), text.size());
+        record.textLength = static_cast<uint32_t>(text.size());
+        record.treeSize = static_cast<uint32_t>(block.size());
+        record.checksum = recordChecksum(text, block.data(), block.size());
+
+        file.seekp(validEnd);
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(reinterpret_cast<const char*>(text.data()), sizeof(wchar_t) * text.size());
+        file.write(block.data(), block.size());
+        file.flush();
+        if (!file)
+            throw std::runtime_error("parse cache: write failed");
+
+        index.emplace(record.hash, validEnd);
+        validEnd += recordSize(record);
+        return true;
+    }
+
+    // Reads flat list block of a statement into tree
+    // Use FlatListView::fromBuffer to access it
+    // Throws std::runtime_error if the record does not match its checksum
+    bool lookup(NodeTag kind, const std::wstring& text, std::vector<char>& tree)
+    {
+        checkKind(kind);
+        std::streamoff offset = find(kind, text);
+        if (offset < 0) return false;
+
+        ParseCacheRecord record = readRecord(offset);
+        tree.resize(record.treeSize);
+        file.seekg(offset + static_cast<std::streamoff>(sizeof(record) + sizeof(wchar_t) * record.textLength));
+        file.read(tree.data(), tree.size());
+        if (!file)
+            throw std::runtime_error("parse cache: read failed");
+        if (recordChecksum(text, tree.data(), tree.size()) != record.checksum)
+            throw std::runtime_error("parse cache: corrupted record");
+        return true;
+    }
+
+    size_t size() const { return index.size(); }
+
+private:
+    ParseCacheFile(const ParseCacheFile&);
+    ParseCacheFile& operator=(const ParseCacheFile&);
+
+    std::fstream file;
+    std::streamoff validEnd;
+    std::unordered_multimap<uint64_t, std::streamoff> index;
+
+    static void checkKind(NodeTag kind)
+    {
+        if (kind != T_PrepareStmt && kind != T_ExecuteStmt)
+            throw std::invalid_argument("parse cache: unsupported statement kind");
+    }
+
+    static std::streamoff recordSize(const ParseCacheRecord& record)
+    {
+        return static_cast<std::streamoff>(sizeof(record) + sizeof(wchar_t) * record.textLength + record.treeSize);
+    }
+
+    ParseCacheRecord readRecord(std::streamoff offset)
+    {
+        ParseCacheRecord record;
+        file.seekg(offset);
+        file.read(reinterpret_cast<char*>(&record), sizeof(record));
+        return record;
+    }
+
+    // Returns record offset or -1
+    // Hash collisions are resolved by comparing stored text
+    std::streamoff find(NodeTag kind, const std::wstring& text)
+    {
+        auto range = index.equal_range(statementHash(text.data(), text.size()));
+        std::wstring storedText;
+        for (auto it = range.first; it != range.second; ++it) {
+            ParseCacheRecord record = readRecord(it->second);
+            if (record.kind != kind || record.textLength != text.size()) continue;
+            storedText.resize(record.textLength);
+            file.read(reinterpret_cast<char*>(&storedText[0]), sizeof(wchar_t) * record.textLength);
+            if (storedText == text) return it->second;
+        }
+        file.clear();
+        return -1;
+    }
+};
+
+#endif
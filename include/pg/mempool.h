@@ -0,0 +1,278 @@
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/*
+ * Recycling pool for small chunks of the global heap
+ *
+ * Long running sessions create and destroy the same node shapes all the
+ * time (ListCell, IdentExt, List, short names). Freed chunks of up to
+ * PoolMaxChunkSize bytes are kept on free lists per size class instead
+ * of being returned to the heap, so the next allocation of the same
+ * shape reuses them. Every size class has a per-thread cache, which
+ * needs no locking, and a bounded global depot that moves free chunks
+ * between threads in batches. Chunks above depot bound go back to heap.
+ * Caches of all running threads are registered in the depot, so
+ * statistics cover every thread.
+ *
+ * palloc uses the pool when no memory context is current.
+ */
+
+const size_t PoolSizeClasses[] = { 16, 24, 32, 48, 64, 80, 96, 128, 160 };
+const int	PoolNumClasses = sizeof(PoolSizeClasses) / sizeof(PoolSizeClasses[0]);
+const size_t PoolMaxChunkSize = 160;
+/* free chunks kept per size class in thread cache and in depot */
+const size_t PoolThreadCacheLimit = 256;
+const size_t PoolBatchSize = 64;
+const size_t PoolDepotLimit = 16 * 1024;
+
+typedef struct PoolClassStats
+{
+	size_t		chunkSize;
+	uint64_t	allocations;	/* requests served by the size class */
+	uint64_t	hits;			/* requests served from free chunks */
+
+	double hitRate() const
+	{
+		return allocations ? static_cast<double>(hits) / static_cast<double>(allocations) : 0.0;
+	}
+} PoolClassStats;
+
+/* returns size class index or -1 for chunks not handled by pool */
+inline int
+poolSizeClass(size_t size)
+{
+	for (int i = 0; i < PoolNumClasses; ++i)
+	{
+		if (size <= PoolSizeClasses[i])
+			return i;
+	}
+	return -1;
+}
+
+struct PoolFreeChunk
+{
+	PoolFreeChunk *next;
+};
+
+struct PoolThreadCache;
+
+/*
+ * Global depot, also registry of thread caches for poolStats.
+ * Depot is never destroyed: chunks can be freed by static destructors
+ * and by thread caches of threads finishing after exit started.
+ */
+struct PoolDepot
+{
+	std::mutex	mutex;
+	std::vector<void *> chunks[PoolNumClasses];
+	/* caches of running threads */
+	std::vector<PoolThreadCache *> caches;
+	/* statistics of finished threads */
+	uint64_t	allocations[PoolNumClasses];
+	uint64_t	hits[PoolNumClasses];
+
+	PoolDepot()
+	{
+		for (int i = 0; i < PoolNumClasses; ++i)
+		{
+			allocations[i] = 0;
+			hits[i] = 0;
+		}
+	}
+};
+
+inline PoolDepot &
+poolDepot()
+{
+	static PoolDepot *depot = new PoolDepot();
+	return *depot;
+}
+
+/*
+ * Set when thread cache of this thread is destroyed. Chunks allocated or
+ * freed later in thread teardown bypass the pool. Flag is trivially
+ * destructible, so it stays readable after destructor of the cache.
+ */
+inline bool &
+poolThreadCacheGone()
+{
+	static thread_local bool gone = false;
+	return gone;
+}
+
+struct PoolThreadCache
+{
+	PoolFreeChunk *heads[PoolNumClasses];
+	size_t		counts[PoolNumClasses];
+	/* written by owning thread only, read by poolStats of any thread */
+	std::atomic<uint64_t> allocations[PoolNumClasses];
+	std::atomic<uint64_t> hits[PoolNumClasses];
+
+	PoolThreadCache()
+	{
+		for (int i = 0; i < PoolNumClasses; ++i)
+		{
+			heads[i] = NULL;
+			counts[i] = 0;
+			allocations[i].store(0, std::memory_order_relaxed);
+			hits[i].store(0, std::memory_order_relaxed);
+		}
+		PoolDepot  &depot = poolDepot();
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		depot.caches.push_back(this);
+	}
+
+	~PoolThreadCache()
+	{
+		poolThreadCacheGone() = true;
+		for (int i = 0; i < PoolNumClasses; ++i)
+			release(i, counts[i]);
+
+		PoolDepot  &depot = poolDepot();
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		for (int i = 0; i < PoolNumClasses; ++i)
+		{
+			depot.allocations[i] += allocations[i].load(std::memory_order_relaxed);
+			depot.hits[i] += hits[i].load(std::memory_order_relaxed);
+		}
+		for (size_t i = 0; i < depot.caches.size(); ++i)
+		{
+			if (depot.caches[i] == this)
+			{
+				depot.caches[i] = depot.caches.back();
+				depot.caches.pop_back();
+				break;
+			}
+		}
+	}
+
+	/* single writer, so no read-modify-write is needed */
+	static void count(std::atomic<uint64_t> &counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void *pop(int sizeClass)
+	{
+		PoolFreeChunk *chunk = heads[sizeClass];
+		heads[sizeClass] = chunk->next;
+		--counts[sizeClass];
+		return chunk;
+	}
+
+	void push(int sizeClass, void *memory)
+	{
+		PoolFreeChunk *chunk = static_cast<PoolFreeChunk *>(memory);
+		chunk->next = heads[sizeClass];
+		heads[sizeClass] = chunk;
+		++counts[sizeClass];
+	}
+
+	/* takes up to PoolBatchSize chunks from depot */
+	void refill(int sizeClass)
+	{
+		PoolDepot  &depot = poolDepot();
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		auto	   &chunks = depot.chunks[sizeClass];
+		for (size_t i = 0; i < PoolBatchSize && !chunks.empty(); ++i)
+		{
+			push(sizeClass, chunks.back());
+			chunks.pop_back();
+		}
+	}
+
+	/* moves count chunks to depot, what does not fit goes to heap */
+	void release(int sizeClass, size_t count)
+	{
+		PoolDepot  &depot = poolDepot();
+		std::lock_guard<std::mutex> lock(depot.mutex);
+		auto	   &chunks = depot.chunks[sizeClass];
+		for (size_t i = 0; i < count; ++i)
+		{
+			void	   *chunk = pop(sizeClass);
+			if (chunks.size() < PoolDepotLimit)
+				chunks.push_back(chunk);
+			else
+				::operator delete(chunk);
+		}
+	}
+};
+
+/* Returns cache of this thread, NULL once it is destroyed */
+inline PoolThreadCache *
+poolThreadCache()
+{
+	if (poolThreadCacheGone())
+		return NULL;
+	static thread_local PoolThreadCache cache;
+	return &cache;
+}
+
+/* Allocates size bytes, small sizes are served by pool */
+inline void *
+poolAlloc(size_t size)
+{
+	int			sizeClass = poolSizeClass(size);
+	PoolThreadCache *cache = sizeClass < 0 ? NULL : poolThreadCache();
+	if (!cache)
+		return ::operator new(size);
+
+	PoolThreadCache::count(cache->allocations[sizeClass]);
+	if (!cache->heads[sizeClass])
+		cache->refill(sizeClass);
+	if (cache->heads[sizeClass])
+	{
+		PoolThreadCache::count(cache->hits[sizeClass]);
+		return cache->pop(sizeClass);
+	}
+	return ::operator new(PoolSizeClasses[sizeClass]);
+}
+
+/* Releases memory of poolAlloc, size has to be the same */
+inline void
+poolFree(void *memory, size_t size)
+{
+	int			sizeClass = poolSizeClass(size);
+	PoolThreadCache *cache = sizeClass < 0 ? NULL : poolThreadCache();
+	if (!cache)
+	{
+		::operator delete(memory);
+		return;
+	}
+
+	cache->push(sizeClass, memory);
+	if (cache->counts[sizeClass] > PoolThreadCacheLimit)
+		cache->release(sizeClass, PoolBatchSize);
+}
+
+/* Returns statistics of all size classes, summed over all threads */
+inline std::vector<PoolClassStats>
+poolStats()
+{
+	PoolDepot  &depot = poolDepot();
+	std::lock_guard<std::mutex> lock(depot.mutex);
+	std::vector<PoolClassStats> stats;
+	for (int i = 0; i < PoolNumClasses; ++i)
+	{
+		PoolClassStats classStats;
+		classStats.chunkSize = PoolSizeClasses[i];
+		classStats.allocations = depot.allocations[i];
+		classStats.hits = depot.hits[i];
+		for (auto cache : depot.caches)
+		{
+			classStats.allocations += cache->allocations[i].load(std::memory_order_relaxed);
+			classStats.hits += cache->hits[i].load(std::memory_order_relaxed);
+		}
+		stats.push_back(classStats);
+	}
+	return stats;
+}
+
+#endif   /* MEMPOOL_H */
@@ -30,6 +30,7 @@ enum NodeTag
 	 * TAGS FOR MEMORY NODES (memnodes.h)
 	 */
 	T_AllocSetContext = 600,
+	T_BulkBlockContext,
 
 	/*
 	 * TAGS FOR VALUE NODES (value.h)
@@ -112,4 +113,6 @@ enum NodeTag
 	T_XmlSerialize,
 	T_WithClause,
 	T_CommonTableExpr,
+	T_IdentView,
+	T_IdentEncoded,
 };
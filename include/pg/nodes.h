@@ -2,6 +2,7 @@
 #define NODES_H
 
 #include "node_tags.h"
+#include "palloc.h"
 
 typedef enum NodeTag NodeTag;
 
@@ -27,6 +28,15 @@ typedef struct Node
 	virtual ~Node()
 	{
 	}
+	/* nodes are allocated in current memory context (palloc.h) */
+	static void *operator new(size_t size)
+	{
+		return palloc(size);
+	}
+	static void operator delete(void *pointer, size_t size)
+	{
+		pfree(pointer, size);
+	}
 	NodeTag		type;
 } Node;
 
@@ -0,0 +1,263 @@
+#ifndef PALLOC_H
+#define PALLOC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "node_tags.h"
+#include "mempool.h"
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+/*
+ * Memory contexts
+ *
+ * Chunks carry no header. Memory of contexts is taken from the heap in
+ * blocks of whole granules (MemoryGranuleSize bytes, aligned to it), and
+ * every granule of such a block is recorded in a global two-level map
+ * from address to owning context. pfree finds the owner of a chunk with
+ * two loads from the map; chunks outside of any context block belong to
+ * the global heap and go to the recycling pool (mempool.h), which needs
+ * their size, so pfree takes the size given to palloc.
+ * Current context is kept per thread, palloc allocates from it.
+ * When no context is current, chunks come from the global heap.
+ */
+
+typedef struct MemoryContextData
+{
+	NodeTag		type;
+
+	MemoryContextData(NodeTag t) : type(t)
+	{
+	}
+	virtual ~MemoryContextData()
+	{
+	}
+	/* returns memory for size bytes of chunk */
+	virtual void *allocChunk(size_t size) = 0;
+	/* releases memory returned by allocChunk */
+	virtual void freeChunk(void *chunk) = 0;
+} MemoryContextData;
+
+typedef MemoryContextData *MemoryContext;
+
+const int	MemoryGranuleShift = 16;
+const size_t MemoryGranuleSize = static_cast<size_t>(1) << MemoryGranuleShift;
+/* map covers 48-bit addresses: root entry per 4 GiB, leaf entry per granule */
+const int	MemoryMapLeafBits = 32 - MemoryGranuleShift;
+const int	MemoryMapRootBits = 48 - 32;
+
+/* chunks of contexts are aligned as the heap aligns them */
+const size_t MemoryChunkAlignment = alignof(std::max_align_t);
+
+inline size_t
+maxAlign(size_t size)
+{
+	return (size + MemoryChunkAlignment - 1) & ~(MemoryChunkAlignment - 1);
+}
+
+/* Rounds block size up to whole granules */
+inline size_t
+granuleAlign(size_t size)
+{
+	return (size + MemoryGranuleSize - 1) & ~(MemoryGranuleSize - 1);
+}
+
+typedef struct MemoryMapLeaf
+{
+	std::atomic<MemoryContext> contexts[static_cast<size_t>(1) << MemoryMapLeafBits];
+} MemoryMapLeaf;
+
+inline std::atomic<MemoryMapLeaf *> *
+memoryMapRoot()
+{
+	/* zero initialized, leaves are never released */
+	static std::atomic<MemoryMapLeaf *> root[static_cast<size_t>(1) << MemoryMapRootBits];
+	return root;
+}
+
+/* Returns context owning chunk, NULL for chunks of the global heap */
+inline MemoryContext
+getMemoryChunkContext(const void *pointer)
+{
+	uint64_t	address = reinterpret_cast<uintptr_t>(pointer);
+	if (address >> 48)
+		return NULL;
+	MemoryMapLeaf *leaf = memoryMapRoot()[address >> 32].load(std::memory_order_acquire);
+	if (!leaf)
+		return NULL;
+	return leaf->contexts[(address & 0xFFFFFFFFu) >> MemoryGranuleShift].load(std::memory_order_acquire);
+}
+
+/* Records context as owner of granules of block (NULL removes the record) */
+inline void
+mapMemoryBlock(const void *block, size_t size, MemoryContext context)
+{
+	uint64_t	address = reinterpret_cast<uintptr_t>(block);
+	uint64_t	end = address + size;
+	if (end >> 48)
+		throw std::bad_alloc();
+	for (; address < end; address += MemoryGranuleSize)
+	{
+		std::atomic<MemoryMapLeaf *> &rootEntry = memoryMapRoot()[address >> 32];
+		MemoryMapLeaf *leaf = rootEntry.load(std::memory_order_acquire);
+		if (!leaf)
+		{
+			MemoryMapLeaf *created = new MemoryMapLeaf();
+			if (rootEntry.compare_exchange_strong(leaf, created, std::memory_order_acq_rel))
+				leaf = created;
+			else
+				delete created;
+		}
+		leaf->contexts[(address & 0xFFFFFFFFu) >> MemoryGranuleShift].store(context, std::memory_order_release);
+	}
+}
+
+/*
+ * Blocks of one granule released by contexts are kept for the next
+ * contexts (most of contexts are short lived and that small), up to
+ * MemoryBlockCacheLimit of them. Aligned blocks are expensive to get
+ * from the heap, usually each one is mapped and unmapped by the system.
+ */
+const size_t MemoryBlockCacheLimit = 64;
+
+typedef struct MemoryBlockCache
+{
+	std::mutex	mutex;
+	std::vector<void *> blocks;
+} MemoryBlockCache;
+
+inline MemoryBlockCache &
+memoryBlockCache()
+{
+	/* never destroyed, contexts can be released by static destructors */
+	static MemoryBlockCache *cache = new MemoryBlockCache();
+	return *cache;
+}
+
+/*
+ * Allocates block of context memory, size is rounded to whole granules.
+ * Context of the block is set by mapMemoryBlock.
+ */
+inline void *
+allocMemoryBlock(size_t size)
+{
+	size = granuleAlign(size);
+	if (size == MemoryGranuleSize)
+	{
+		MemoryBlockCache &cache = memoryBlockCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		if (!cache.blocks.empty())
+		{
+			void	   *block = cache.blocks.back();
+			cache.blocks.pop_back();
+			return block;
+		}
+	}
+
+	void	   *block;
+#ifdef _MSC_VER
+	block = _aligned_malloc(size, MemoryGranuleSize);
+#else
+	if (posix_memalign(&block, MemoryGranuleSize, size) != 0)
+		block = NULL;
+#endif
+	if (!block)
+		throw std::bad_alloc();
+	return block;
+}
+
+/* Releases block of allocMemoryBlock, record of its context is removed */
+inline void
+freeMemoryBlock(void *block, size_t size)
+{
+	size = granuleAlign(size);
+	mapMemoryBlock(block, size, NULL);
+	if (size == MemoryGranuleSize)
+	{
+		MemoryBlockCache &cache = memoryBlockCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		if (cache.blocks.size() < MemoryBlockCacheLimit)
+		{
+			cache.blocks.push_back(block);
+			return;
+		}
+	}
+#ifdef _MSC_VER
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+
+inline MemoryContext &
+currentMemoryContextRef()
+{
+	static thread_local MemoryContext current = NULL;
+	return current;
+}
+
+/* Returns context used by palloc in this thread */
+inline MemoryContext
+currentMemoryContext()
+{
+	return currentMemoryContextRef();
+}
+
+/* Makes context current in this thread and returns previous one */
+inline MemoryContext
+memoryContextSwitchTo(MemoryContext context)
+{
+	MemoryContext old = currentMemoryContextRef();
+	currentMemoryContextRef() = context;
+	return old;
+}
+
+inline void *
+pallocIn(MemoryContext context, size_t size)
+{
+	return context ? context->allocChunk(size) : poolAlloc(size);
+}
+
+inline void *
+palloc(size_t size)
+{
+	return pallocIn(currentMemoryContext(), size);
+}
+
+/* Releases chunk of palloc, size is the one it was allocated with */
+inline void
+pfree(void *pointer, size_t size)
+{
+	if (!pointer)
+		return;
+	MemoryContext context = getMemoryChunkContext(pointer);
+	if (context)
+		context->freeChunk(pointer);
+	else
+		poolFree(pointer, size);
+}
+
+/* RAII switch of current context */
+struct MemoryContextScope
+{
+	explicit MemoryContextScope(MemoryContext context) : old(memoryContextSwitchTo(context))
+	{
+	}
+	~MemoryContextScope()
+	{
+		memoryContextSwitchTo(old);
+	}
+private:
+	MemoryContextScope(const MemoryContextScope&);
+	MemoryContextScope& operator=(const MemoryContextScope&);
+	MemoryContext old;
+};
+
+#endif   /* PALLOC_H */
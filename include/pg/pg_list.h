@@ -18,6 +18,15 @@ typedef struct List
 
 struct ListCell
 {
+	/* cells are allocated in current memory context (palloc.h) */
+	static void *operator new(size_t size)
+	{
+		return palloc(size);
+	}
+	static void operator delete(void *pointer, size_t size)
+	{
+		pfree(pointer, size);
+	}
 	union
 	{
 		void	   *ptr_value;
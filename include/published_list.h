@@ -0,0 +1,167 @@
+#ifndef PUBLISHED_LIST_H
+#define PUBLISHED_LIST_H
+
+#include <atomic>
+#include "list_tools.h"
+#include "epoch_reclamation.h"
+
+// List updated by one writer thread and read by many reader threads
+// without locks (e.g. catalog cache lists of qualified names)
+// Writer links a new cell at the end and then publishes head and length
+// with release semantics (under a sequence counter, so both are read
+// consistently). Reader loads them with acquire and walks only length
+// cells, so it never reads the next pointer of the last published cell
+// (the only one writer still modifies).
+// Published cells are never modified otherwise: erase copies cells
+// before the erased one and publishes the new head, old cells are
+// retired through epoch-based reclamation (epoch_reclamation.h).
+// Readers have to hold EpochGuard while using snapshot if list is erased from.
+
+// Forward iterator for ListSnapshot, stops after snapshot length cells
+struct ListSnapshotIterator
+    :public std::iterator<std::forward_iterator_tag, ListCell*>
+{
+    ListSnapshotIterator(ListCell* cell, int remaining) :nodePtr(cell), left(remaining) {}
+    ListCell* operator*() const { return nodePtr; }
+    bool operator != (const ListSnapshotIterator& rhs) const { return nodePtr != rhs.nodePtr; }
+    bool operator == (const ListSnapshotIterator& rhs) const { return nodePtr == rhs.nodePtr; }
+
+    ListSnapshotIterator& operator++()
+    {
+        nodePtr = --left > 0 ? nodePtr->next : nullptr;
+        return *this;
+    }
+
+    ListSnapshotIterator operator++(int)
+    {
+        ListSnapshotIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+private:
+    ListCell* nodePtr;
+    int left;
+};
+
+// Read-only view of first length elements of published list
+struct ListSnapshot
+{
+    ListSnapshot(ListCell* h, int l) :head(h), length(l) {}
+    ListCell* head;
+    int length;
+};
+
+// Returns snapshot head
+ListSnapshotIterator begin(const ListSnapshot& snapshot)
+{
+    return ListSnapshotIterator(snapshot.length ? snapshot.head : nullptr, snapshot.length);
+}
+// Returns snapshot end
+ListSnapshotIterator end(const ListSnapshot&) { return ListSnapshotIterator(nullptr, 0); }
+
+struct PublishedList
+{
+    PublishedList() :list(makeList()), version(0), head(nullptr), length(0) {}
+    ~PublishedList() { clean(list); }
+
+    // Writer thread only
+    template<typename ValueType>
+    void push_back(ValueType value)
+    {
+        ::push_back(list, value);
+        publish();
+    }
+
+    // Writer thread only
+    // Removes first element for which predicate(cell) is true.
+    // Cells are retired by writer, node kept in the cell
+    // is not touched (it can be retired with writer.retireNode).
+    template<typename Predicate>
+    bool erase(Predicate predicate, EpochParticipant& writer)
+    {
+        ListCell* toErase = list.head;
+        while (toErase && !predicate(toErase)) toErase = toErase->next;
+        if (!toErase) return false;
+
+        // copy cells before erased one, readers may walk the old ones
+        ListCell* newHead = toErase->next;
+        ListCell* prefixTail = nullptr;
+        for (ListCell* cell = list.head; cell != toErase; cell = cell->next) {
+            ListCell* copy = allocCell();
+            copy->data = cell->data;
+            copy->next = toErase->next;
+            if (prefixTail) prefixTail->next = copy;
+            else newHead = copy;
+            prefixTail = copy;
+        }
+
+        ListCell* oldHead = list.head;
+        list.head = newHead;
+        if (toErase == list.tail) list.tail = prefixTail;
+        --list.length;
+        publish();
+
+        for (ListCell* cell = oldHead; cell != toErase; cell = cell->next) writer.retireCell(cell);
+        writer.retireCell(toErase);
+        return true;
+    }
+
+    // Writer thread only
+    const List& writerList() const { return list; }
+
+    // Any thread, snapshot stays valid as long as list is not destroyed
+    // (and during EpochGuard if list is erased from)
+    ListSnapshot snapshot() const
+    {
+        while (true) {
+            // seq_cst orders it after EpochGuard announcement
+            unsigned before = version.load(std::memory_order_seq_cst);
+            ListCell* publishedHead = head.load(std::memory_order_acquire);
+            int publishedLength = length.load(std::memory_order_acquire);
+            if (!(before & 1) && version.load(std::memory_order_relaxed) == before) {
+                return ListSnapshot(publishedHead, publishedLength);
+            }
+        }
+    }
+
+private:
+    PublishedList(const PublishedList&);
+    PublishedList& operator=(const PublishedList&);
+
+    List list;
+    // odd while head and length are being published
+    std::atomic<unsigned> version;
+    std::atomic<ListCell*> head;
+    std::atomic<int> length;
+
+    void publish()
+    {
+        // reader that sees new head or length sees odd version as well
+        unsigned current = version.load(std::memory_order_relaxed);
+        version.store(current + 1, std::memory_order_relaxed);
+        head.store(list.head, std::memory_order_release);
+        length.store(list.length, std::memory_order_release);
+        // seq_cst orders it before epoch of retired cells
+        version.store(current + 2, std::memory_order_seq_cst);
+    }
+};
+
+// ListNodeTrait implementation for ListSnapshot
+// reverse() is not provided as snapshot is read-only
+template<>
+struct ListNodeTrait<ListSnapshot>
+{
+    typedef ListCell* node;
+    typedef ListSnapshotIterator iterator;
+
+    static iterator begin(const ListSnapshot& snapshot) { return ::begin(snapshot); }
+    static iterator end(const ListSnapshot& snapshot) { return ::end(snapshot); }
+
+    static void appendElement(ListCell* node, bool& firstElement, std::wstring& result)
+    {
+        ListNodeTrait<List>::appendElement(node, firstElement, result);
+    }
+};
+
+#endif
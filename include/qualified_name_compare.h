@@ -0,0 +1,147 @@
+#ifndef QUALIFIED_NAME_COMPARE_H
+#define QUALIFIED_NAME_COMPARE_H
+
+#include <algorithm>
+#include "list_tools.h"
+
+// Comparison of Ident lists with dotted names without rendering
+//     qualifiedNameEquals(list, L"schema.table.column", 19)
+// Dotted text is split on every '.' (no quoting, names containing dots
+// can not be matched), empty text is an empty name list.
+// Parts are compared in place with Idents of any flavour, nothing is
+// allocated. Order of parts is given by flags:
+//     CompareListOrder - first part is the head of the list
+//     CompareReversed  - first part is the tail of the list
+//                        (as built by parseQualifiedName and rendered
+//                        by reverse_impl_*); list is walked from the
+//                        head while text is read from its end
+// CompareIgnoreCase folds A-Z only, like RenderFolded.
+
+enum QualifiedNameCompareFlags
+{
+    CompareListOrder = 0,
+    CompareReversed = 1,
+    CompareIgnoreCase = 2
+};
+
+inline uint32_t foldCodePoint(uint32_t codePoint, bool ignoreCase)
+{
+    return ignoreCase && codePoint >= 'A' && codePoint <= 'Z' ? codePoint + ('a' - 'A') : codePoint;
+}
+
+// Compares name of Ident of any flavour with a part of dotted text
+// by code points, returns <0, 0, >0
+int compareIdentPart(const Node* node, const wchar_t* part, size_t length, bool ignoreCase)
+{
+    const wchar_t* end = part + length;
+    if (node->type != T_IdentEncoded) {
+        IdentName name = identName(node);
+        if (!ignoreCase && sizeof(wchar_t) == 4) {
+            int result = wmemcmp(name.data, part, std::min(name.length, length));
+            if (result) return result;
+            return name.length < length ? -1 : name.length > length ? 1 : 0;
+        }
+        const wchar_t* text = name.data;
+        const wchar_t* nameEnd = name.data + name.length;
+        while (text < nameEnd && part < end) {
+            uint32_t a = foldCodePoint(readWide(text, nameEnd), ignoreCase);
+            uint32_t b = foldCodePoint(readWide(part, end), ignoreCase);
+            if (a != b) return a < b ? -1 : 1;
+        }
+        return text < nameEnd ? 1 : part < end ? -1 : 0;
+    }
+    int result = 0;
+    forEachIdentCodePoint(node, [&](uint32_t codePoint) {
+        if (result) return;
+        if (part == end) {
+            result = 1;
+            return;
+        }
+        uint32_t a = foldCodePoint(codePoint, ignoreCase);
+        uint32_t b = foldCodePoint(readWide(part, end), ignoreCase);
+        if (a != b) result = a < b ? -1 : 1;
+    });
+    return result ? result : part < end ? -1 : 0;
+}
+
+// Returns end of part of dotted text starting at begin
+inline const wchar_t* dottedPartEnd(const wchar_t* begin, const wchar_t* end)
+{
+    return std::find(begin, end, L'.');
+}
+
+// Returns begin of part of dotted text ending at end
+inline const wchar_t* dottedPartBegin(const wchar_t* begin, const wchar_t* end)
+{
+    while (end > begin && end[-1] != L'.') --end;
+    return end;
+}
+
+// Checks if list of Idents names the same object as dotted text
+// Stops at the first part that differs
+bool qualifiedNameEquals(const List& list, const wchar_t* dotted, size_t length, unsigned flags = CompareListOrder)
+{
+    bool ignoreCase = (flags & CompareIgnoreCase) != 0;
+    const wchar_t* begin = dotted;
+    const wchar_t* end = dotted + length;
+    const ListCell* cell = list.head;
+    if (length == 0) return cell == nullptr;
+    for (;; cell = cell->next) {
+        if (!cell) return false;
+        const wchar_t* partBegin = flags & CompareReversed ? dottedPartBegin(begin, end) : begin;
+        const wchar_t* partEnd = flags & CompareReversed ? end : dottedPartEnd(begin, end);
+        if (compareIdentPart(castNode<Node>(cell), partBegin, static_cast<size_t>(partEnd - partBegin), ignoreCase) != 0) return false;
+        // the last part has no separator
+        if (flags & CompareReversed) {
+            if (partBegin == begin) break;
+            end = partBegin - 1;
+        } else {
+            if (partEnd == end) break;
+            begin = partEnd + 1;
+        }
+    }
+    return cell->next == nullptr;
+}
+
+// Orders list of Idents and dotted text by their parts in order
+// of the text, shorter name goes first when one is a prefix of the other
+// Returns <0 if list goes before text, 0 if they are equal, >0 otherwise
+// List order stops at the first part that differs, reversed order
+// compares all common parts (list can not be walked from its tail).
+int qualifiedNameCompare(const List& list, const wchar_t* dotted, size_t length, unsigned flags = CompareListOrder)
+{
+    bool ignoreCase = (flags & CompareIgnoreCase) != 0;
+    const wchar_t* begin = dotted;
+    const wchar_t* end = dotted + length;
+    size_t listParts = static_cast<size_t>(list.length);
+    size_t textParts = length ? static_cast<size_t>(std::count(begin, end, L'.')) + 1 : 0;
+    size_t common = std::min(listParts, textParts);
+    int lengthOrder = listParts < textParts ? -1 : listParts > textParts ? 1 : 0;
+
+    const ListCell* cell = list.head;
+    if (!(flags & CompareReversed)) {
+        for (size_t i = 0; i < common; ++i, cell = cell->next) {
+            const wchar_t* partEnd = dottedPartEnd(begin, end);
+            int result = compareIdentPart(castNode<Node>(cell), begin, static_cast<size_t>(partEnd - begin), ignoreCase);
+            if (result) return result;
+            if (partEnd < end) begin = partEnd + 1;
+        }
+        return lengthOrder;
+    }
+    if (common == 0) return lengthOrder;
+
+    // parts beyond common ones are at the head of the list and the end of the text
+    for (size_t i = common; i < listParts; ++i) cell = cell->next;
+    for (size_t i = common; i < textParts; ++i) end = dottedPartBegin(begin, end) - 1;
+    // parts are met from the last to the first one, the first difference wins
+    int order = 0;
+    for (size_t i = 0; i < common; ++i, cell = cell->next) {
+        const wchar_t* partBegin = dottedPartBegin(begin, end);
+        int result = compareIdentPart(castNode<Node>(cell), partBegin, static_cast<size_t>(end - partBegin), ignoreCase);
+        if (result) order = result;
+        if (partBegin > begin) end = partBegin - 1;
+    }
+    return order ? order : lengthOrder;
+}
+
+#endif
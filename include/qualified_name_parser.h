@@ -0,0 +1,231 @@
+#ifndef QUALIFIED_NAME_PARSER_H
+#define QUALIFIED_NAME_PARSER_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bulk_list.h"
+#include "char_search.h"
+
+// Parser of dotted qualified names (inverse of reverse renderers)
+//     schema."Table.Name".column  ->  (column, Table.Name, schema)
+// Parts are listed most specific first, as reverse_impl_* and
+// NameResolutionTrie expect, so reverse_impl_1(parseQualifiedName(s))
+// gives s back for names that do not need quoting.
+// Parts are separated by '.', part in double quotes can contain
+// any character, quote inside is written twice ("a""b" is a"b).
+// Empty parts are not allowed, empty text gives empty List.
+// Separators and quotes are searched 16 bytes at a time (char_search.h).
+// Text is scanned once: parts are collected and names that are not
+// stored in the text as they are (UTF-8 text, doubled quotes) are decoded
+// once into a buffer, then Idents, cells and names of the result take
+// one allocation (see makeIdentList).
+// parseQualifiedNameViews does not copy names, they are IdentViews
+// pointing into the text.
+// Idents of quoted parts are marked RenderFlagSourceQuoted, so folding
+// renderers keep their case.
+
+// Appends characters of name part converted to wchar_t
+void appendNameChars(const wchar_t* begin, const wchar_t* end, std::wstring& out)
+{
+    out.append(begin, end);
+}
+
+// UTF-8 version, code points above U+FFFF take two characters
+// when wchar_t is 16 bits wide
+void appendNameChars(const char* begin, const char* end, std::wstring& out)
+{
+    forEachUtf8CodePoint(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end), [&](uint32_t codePoint) {
+        wchar_t buffer[2];
+        out.append(buffer, writeWide(buffer, codePoint));
+    });
+}
+
+// Splits qualified name into parts, see parseQualifiedName
+template<typename Char>
+struct QualifiedNameScanner
+{
+    QualifiedNameScanner(const Char* t, size_t l) :text(t), length(l), position(0), done(l == 0) {}
+
+    // Moves to next part, returns false after the last one
+    // Throws std::invalid_argument for malformed text
+    bool next()
+    {
+        if (done) return false;
+        if (position == length) throw std::invalid_argument("parseQualifiedName: empty name part");
+        quoted = text[position] == Char('"');
+        doubled = false;
+        if (quoted) {
+            begin = ++position;
+            // skip doubled quotes inside
+            while ((position = findChar(text, position, length, Char('"'))) + 1 < length
+                && text[position + 1] == Char('"')) {
+                position += 2;
+                doubled = true;
+            }
+            if (position == length) throw std::invalid_argument("parseQualifiedName: unterminated quoted name");
+            end = position++;
+            if (position < length && text[position] != Char('.')) {
+                throw std::invalid_argument("parseQualifiedName: '.' expected after quoted name");
+            }
+        } else {
+            begin = position;
+            position = findAnyOf(text, position, length, Char('.'), Char('"'));
+            if (position < length && text[position] == Char('"')) {
+                throw std::invalid_argument("parseQualifiedName: quote inside unquoted name");
+            }
+            end = position;
+        }
+        if (begin == end) throw std::invalid_argument("parseQualifiedName: empty name part");
+        if (position == length) done = true;
+        else ++position;
+        return true;
+    }
+
+    // Returns true if name of current part is stored in text as is
+    // (it is not quoted or quoted without doubled quotes inside)
+    bool isVerbatim() const { return !doubled; }
+    bool isQuoted() const { return quoted; }
+
+    size_t nameBegin() const { return begin; }
+    size_t nameEnd() const { return end; }
+
+    // Appends name of current part (unquoted)
+    void decode(std::wstring& out) const
+    {
+        for (size_t from = begin;;) {
+            size_t quote = doubled ? findChar(text, from, end, Char('"')) : end;
+            appendNameChars(text + from, text + quote, out);
+            if (quote == end) break;
+            out.push_back(L'"');
+            from = quote + 2;
+        }
+    }
+
+private:
+    const Char* text;
+    size_t length;
+    size_t position;
+    bool done;
+    bool quoted;
+    bool doubled;
+    size_t begin;
+    size_t end;
+};
+
+// Part of qualified name found by scanQualifiedName
+struct QualifiedNamePart
+{
+    size_t begin;      // name in text, quotes excluded
+    size_t end;
+    size_t decoded;    // position of name in decoded names, npos if it is text[begin, end)
+    size_t length;     // length of name in wide characters
+    bool quoted;       // part is written in double quotes
+};
+
+// Wide text can hold names as they are, UTF-8 text can not
+const wchar_t* wideText(const wchar_t* text) { return text; }
+const wchar_t* wideText(const char*) { return nullptr; }
+
+// Splits qualified name into parts in one pass over text
+// Parts are stored most specific (last in text) first.
+// Names stored in wide text as they are stay there, other ones
+// are decoded into names. Returns sum of name lengths.
+template<typename Char>
+size_t scanQualifiedName(const Char* text, size_t length, std::vector<QualifiedNamePart>& parts, std::wstring& names)
+{
+    size_t nameChars = 0;
+    QualifiedNameScanner<Char> scanner(text, length);
+    while (scanner.next()) {
+        QualifiedNamePart part = { scanner.nameBegin(), scanner.nameEnd(), std::wstring::npos, 0, scanner.isQuoted() };
+        if (wideText(text) && scanner.isVerbatim()) {
+            part.length = part.end - part.begin;
+        } else {
+            part.decoded = names.size();
+            scanner.decode(names);
+            part.length = names.size() - part.decoded;
+        }
+        nameChars += part.length;
+        parts.push_back(part);
+    }
+    std::reverse(parts.begin(), parts.end());
+    return nameChars;
+}
+
+// Returns name of part found by scanQualifiedName
+template<typename Char>
+const wchar_t* partName(const Char* text, const QualifiedNamePart& part, const std::wstring& names)
+{
+    return part.decoded == std::wstring::npos ? wideText(text) + part.begin : names.data() + part.decoded;
+}
+
+template<typename Char>
+List parseQualifiedNameImpl(const Char* text, size_t length)
+{
+    std::vector<QualifiedNamePart> parts;
+    std::wstring names;
+    size_t nameChars = scanQualifiedName(text, length, parts, names);
+
+    auto part = parts.begin();
+    List list = makeIdentList(parts.size(), nameChars, [&](auto allocName) {
+        memcpy(allocName(part->length), partName(text, *part, names), sizeof(wchar_t) * part->length);
+        ++part;
+    });
+    part = parts.begin();
+    for (auto cell : list) {
+        if ((part++)->quoted) markIdentSourceQuoted(castNode<Node>(cell));
+    }
+    return list;
+}
+
+// Parses qualified name into List of Idents
+List parseQualifiedName(const wchar_t* text, size_t length)
+{
+    return parseQualifiedNameImpl(text, length);
+}
+
+// Parses qualified name into List of IdentViews pointing into text,
+// parts with doubled quotes become owning Idents
+// Cells and Idents take one allocation, text has to outlive the result
+List parseQualifiedNameViews(const wchar_t* text, size_t length)
+{
+    std::vector<QualifiedNamePart> parts;
+    std::wstring names;
+    scanQualifiedName(text, length, parts, names);
+    size_t copied = 0;
+    for (auto& part : parts) copied += part.decoded != std::wstring::npos;
+
+    // every part takes space of the larger node
+    size_t nodeSize = std::max(sizeof(IdentView), sizeof(IdentExt));
+    size_t chunksSize = parts.size() * BulkBlockContext::chunkSize(nodeSize)
+        + copied * BulkBlockContext::chunkSize(sizeof(wchar_t)) + sizeof(wchar_t) * names.size();
+    auto part = parts.begin();
+    return makeNodeList(parts.size(), chunksSize, parts.size() + copied, [&](MemoryContext context) -> Node* {
+        const QualifiedNamePart& current = *part++;
+        if (current.decoded == std::wstring::npos) {
+            auto view = ::new (pallocIn(context, sizeof(IdentView))) IdentView();
+            view->type = T_IdentView;
+            view->name = text + current.begin;
+            view->length = current.length;
+            if (current.quoted) markIdentSourceQuoted(view);
+            return view;
+        }
+        auto ident = ::new (pallocIn(context, sizeof(IdentExt))) IdentExt();
+        ident->type = T_Ident;
+        auto buffer = static_cast<wchar_t*>(pallocIn(context, sizeof(wchar_t) * (current.length + 1)));
+        memcpy(buffer, names.data() + current.decoded, sizeof(wchar_t) * current.length);
+        buffer[current.length] = L'\0';
+        ident->name = buffer;
+        // parts with doubled quotes are always quoted
+        markIdentSourceQuoted(ident);
+        return ident;
+    });
+}
+
+// Parses UTF-8 qualified name into List of Idents
+List parseQualifiedName(const char* text, size_t length)
+{
+    return parseQualifiedNameImpl(text, length);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef REVERSED_NAME_BUILDER_H
+#define REVERSED_NAME_BUILDER_H
+
+#include <vector>
+#include "list_tools.h"
+
+// Incremental reversed rendering of a list of Idents
+// Builder appends Idents to the list and keeps its rendering (the same
+// as reverse_impl_*) up to date: name of appended Ident goes before the
+// text rendered so far. Text is kept at the end of a buffer with a gap
+// in front of it, so the name is written into the gap in O(length);
+// when the gap is too small the buffer grows twice and text is moved
+// to its end (amortized O(length) per name).
+// Rendering can be read after every append without recomputation.
+// While builder is used, the list must be changed through it only.
+
+struct ReversedNameBuilder
+{
+    // Renders elements already in list
+    explicit ReversedNameBuilder(List& target) :list(target), start(0), count(0)
+    {
+        buffer.push_back(L'\0');
+        for (auto cell : list) prepend(castNode<Node>(cell));
+    }
+
+    // Appends Ident to the list and its name to the rendering
+    void push_back(Node* ident)
+    {
+        ::push_back(list, ident);
+        prepend(ident);
+    }
+
+    // Current rendering, zero terminated, valid until the next append
+    const wchar_t* c_str() const { return buffer.data() + start; }
+    size_t size() const { return buffer.size() - 1 - start; }
+    std::wstring str() const { return std::wstring(c_str(), size()); }
+
+private:
+    ReversedNameBuilder(const ReversedNameBuilder&);
+    ReversedNameBuilder& operator=(const ReversedNameBuilder&);
+
+    void prepend(const Node* ident)
+    {
+        const wchar_t* name;
+        size_t length;
+        if (ident->type != T_IdentEncoded) {
+            IdentName wide = identName(ident);
+            name = wide.data;
+            length = wide.length;
+        } else {
+            scratch.clear();
+            appendIdentName(ident, scratch);
+            name = scratch.data();
+            length = scratch.size();
+        }
+        size_t needed = length + (count ? 1 : 0);
+        if (start < needed) grow(needed);
+        if (count) buffer[--start] = L'.';
+        start -= length;
+        std::copy(name, name + length, buffer.begin() + static_cast<std::ptrdiff_t>(start));
+        ++count;
+    }
+
+    // Makes gap at least needed characters long, text is moved to the end
+    void grow(size_t needed)
+    {
+        size_t used = buffer.size() - start;
+        size_t capacity = std::max(buffer.size() * 2, used + needed + 16);
+        std::vector<wchar_t> grown(capacity);
+        std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(start), buffer.end(), grown.end() - static_cast<std::ptrdiff_t>(used));
+        buffer.swap(grown);
+        start = capacity - used;
+    }
+
+    List& list;
+    // text is buffer[start, size - 1), the last character is terminator
+    std::vector<wchar_t> buffer;
+    size_t start;
+    size_t count;
+    // names of encoded Idents are rendered here first
+    std::wstring scratch;
+};
+
+#endif
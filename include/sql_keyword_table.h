@@ -0,0 +1,617 @@
+#ifndef SQL_KEYWORD_TABLE_H
+#define SQL_KEYWORD_TABLE_H
+
+// Generated by tools/gen_keyword_table.py from tools/sql_keywords.txt
+// Do not edit, regenerate instead
+
+#include <cstddef>
+#include <cstdint>
+
+enum SqlKeywordCategory
+{
+    UnreservedKeyword,
+    ColNameKeyword,
+    TypeFuncNameKeyword,
+    ReservedKeyword
+};
+
+// Token ids, in order of SqlKeywords
+enum SqlKeywordToken
+{
+    KW_ABORT, KW_ABSENT, KW_ABSOLUTE, KW_ACCESS, KW_ACTION, KW_ADD, KW_ADMIN, KW_AFTER,
+    KW_AGGREGATE, KW_ALL, KW_ALSO, KW_ALTER, KW_ALWAYS, KW_ANALYSE, KW_ANALYZE, KW_AND, KW_ANY,
+    KW_ARRAY, KW_AS, KW_ASC, KW_ASENSITIVE, KW_ASSERTION, KW_ASSIGNMENT, KW_ASYMMETRIC, KW_AT,
+    KW_ATOMIC, KW_ATTACH, KW_ATTRIBUTE, KW_AUTHORIZATION, KW_BACKWARD, KW_BEFORE, KW_BEGIN,
+    KW_BETWEEN, KW_BIGINT, KW_BINARY, KW_BIT, KW_BOOLEAN, KW_BOTH, KW_BREADTH, KW_BY, KW_CACHE,
+    KW_CALL, KW_CALLED, KW_CASCADE, KW_CASCADED, KW_CASE, KW_CAST, KW_CATALOG, KW_CHAIN, KW_CHAR,
+    KW_CHARACTER, KW_CHARACTERISTICS, KW_CHECK, KW_CHECKPOINT, KW_CLASS, KW_CLOSE, KW_CLUSTER,
+    KW_COALESCE, KW_COLLATE, KW_COLLATION, KW_COLUMN, KW_COLUMNS, KW_COMMENT, KW_COMMENTS,
+    KW_COMMIT, KW_COMMITTED, KW_COMPRESSION, KW_CONCURRENTLY, KW_CONFIGURATION, KW_CONFLICT,
+    KW_CONNECTION, KW_CONSTRAINT, KW_CONSTRAINTS, KW_CONTENT, KW_CONTINUE, KW_CONVERSION, KW_COPY,
+    KW_COST, KW_CREATE, KW_CROSS, KW_CSV, KW_CUBE, KW_CURRENT, KW_CURRENT_CATALOG, KW_CURRENT_DATE,
+    KW_CURRENT_ROLE, KW_CURRENT_SCHEMA, KW_CURRENT_TIME, KW_CURRENT_TIMESTAMP, KW_CURRENT_USER,
+    KW_CURSOR, KW_CYCLE, KW_DATA, KW_DATABASE, KW_DAY, KW_DEALLOCATE, KW_DEC, KW_DECIMAL,
+    KW_DECLARE, KW_DEFAULT, KW_DEFAULTS, KW_DEFERRABLE, KW_DEFERRED, KW_DEFINER, KW_DELETE,
+    KW_DELIMITER, KW_DELIMITERS, KW_DEPENDS, KW_DEPTH, KW_DESC, KW_DETACH, KW_DICTIONARY,
+    KW_DISABLE, KW_DISCARD, KW_DISTINCT, KW_DO, KW_DOCUMENT, KW_DOMAIN, KW_DOUBLE, KW_DROP,
+    KW_EACH, KW_ELSE, KW_ENABLE, KW_ENCODING, KW_ENCRYPTED, KW_END, KW_ENUM, KW_ESCAPE, KW_EVENT,
+    KW_EXCEPT, KW_EXCLUDE, KW_EXCLUDING, KW_EXCLUSIVE, KW_EXECUTE, KW_EXISTS, KW_EXPLAIN,
+    KW_EXPRESSION, KW_EXTENSION, KW_EXTERNAL, KW_EXTRACT, KW_FALSE, KW_FAMILY, KW_FETCH, KW_FILTER,
+    KW_FINALIZE, KW_FIRST, KW_FLOAT, KW_FOLLOWING, KW_FOR, KW_FORCE, KW_FOREIGN, KW_FORMAT,
+    KW_FORWARD, KW_FREEZE, KW_FROM, KW_FULL, KW_FUNCTION, KW_FUNCTIONS, KW_GENERATED, KW_GLOBAL,
+    KW_GRANT, KW_GRANTED, KW_GREATEST, KW_GROUP, KW_GROUPING, KW_GROUPS, KW_HANDLER, KW_HAVING,
+    KW_HEADER, KW_HOLD, KW_HOUR, KW_IDENTITY, KW_IF, KW_ILIKE, KW_IMMEDIATE, KW_IMMUTABLE,
+    KW_IMPLICIT, KW_IMPORT, KW_IN, KW_INCLUDE, KW_INCLUDING, KW_INCREMENT, KW_INDENT, KW_INDEX,
+    KW_INDEXES, KW_INHERIT, KW_INHERITS, KW_INITIALLY, KW_INLINE, KW_INNER, KW_INOUT, KW_INPUT,
+    KW_INSENSITIVE, KW_INSERT, KW_INSTEAD, KW_INT, KW_INTEGER, KW_INTERSECT, KW_INTERVAL, KW_INTO,
+    KW_INVOKER, KW_IS, KW_ISNULL, KW_ISOLATION, KW_JOIN, KW_JSON, KW_JSON_ARRAY, KW_JSON_ARRAYAGG,
+    KW_JSON_OBJECT, KW_JSON_OBJECTAGG, KW_KEY, KW_KEYS, KW_LABEL, KW_LANGUAGE, KW_LARGE, KW_LAST,
+    KW_LATERAL, KW_LEADING, KW_LEAKPROOF, KW_LEAST, KW_LEFT, KW_LEVEL, KW_LIKE, KW_LIMIT,
+    KW_LISTEN, KW_LOAD, KW_LOCAL, KW_LOCALTIME, KW_LOCALTIMESTAMP, KW_LOCATION, KW_LOCK, KW_LOCKED,
+    KW_LOGGED, KW_MAPPING, KW_MATCH, KW_MATCHED, KW_MATERIALIZED, KW_MAXVALUE, KW_MERGE, KW_METHOD,
+    KW_MINUTE, KW_MINVALUE, KW_MODE, KW_MONTH, KW_MOVE, KW_NAME, KW_NAMES, KW_NATIONAL, KW_NATURAL,
+    KW_NCHAR, KW_NEW, KW_NEXT, KW_NFC, KW_NFD, KW_NFKC, KW_NFKD, KW_NO, KW_NONE, KW_NORMALIZE,
+    KW_NORMALIZED, KW_NOT, KW_NOTHING, KW_NOTIFY, KW_NOTNULL, KW_NOWAIT, KW_NULL, KW_NULLIF,
+    KW_NULLS, KW_NUMERIC, KW_OBJECT, KW_OF, KW_OFF, KW_OFFSET, KW_OIDS, KW_OLD, KW_ON, KW_ONLY,
+    KW_OPERATOR, KW_OPTION, KW_OPTIONS, KW_OR, KW_ORDER, KW_ORDINALITY, KW_OTHERS, KW_OUT,
+    KW_OUTER, KW_OVER, KW_OVERLAPS, KW_OVERLAY, KW_OVERRIDING, KW_OWNED, KW_OWNER, KW_PARALLEL,
+    KW_PARAMETER, KW_PARSER, KW_PARTIAL, KW_PARTITION, KW_PASSING, KW_PASSWORD, KW_PLACING,
+    KW_PLANS, KW_POLICY, KW_POSITION, KW_PRECEDING, KW_PRECISION, KW_PREPARE, KW_PREPARED,
+    KW_PRESERVE, KW_PRIMARY, KW_PRIOR, KW_PRIVILEGES, KW_PROCEDURAL, KW_PROCEDURE, KW_PROCEDURES,
+    KW_PROGRAM, KW_PUBLICATION, KW_QUOTE, KW_RANGE, KW_READ, KW_REAL, KW_REASSIGN, KW_RECHECK,
+    KW_RECURSIVE, KW_REF, KW_REFERENCES, KW_REFERENCING, KW_REFRESH, KW_REINDEX, KW_RELATIVE,
+    KW_RELEASE, KW_RENAME, KW_REPEATABLE, KW_REPLACE, KW_REPLICA, KW_RESET, KW_RESTART,
+    KW_RESTRICT, KW_RETURN, KW_RETURNING, KW_RETURNS, KW_REVOKE, KW_RIGHT, KW_ROLE, KW_ROLLBACK,
+    KW_ROLLUP, KW_ROUTINE, KW_ROUTINES, KW_ROW, KW_ROWS, KW_RULE, KW_SAVEPOINT, KW_SCALAR,
+    KW_SCHEMA, KW_SCHEMAS, KW_SCROLL, KW_SEARCH, KW_SECOND, KW_SECURITY, KW_SELECT, KW_SEQUENCE,
+    KW_SEQUENCES, KW_SERIALIZABLE, KW_SERVER, KW_SESSION, KW_SESSION_USER, KW_SET, KW_SETOF,
+    KW_SETS, KW_SHARE, KW_SHOW, KW_SIMILAR, KW_SIMPLE, KW_SKIP, KW_SMALLINT, KW_SNAPSHOT, KW_SOME,
+    KW_SQL, KW_STABLE, KW_STANDALONE, KW_START, KW_STATEMENT, KW_STATISTICS, KW_STDIN, KW_STDOUT,
+    KW_STORAGE, KW_STORED, KW_STRICT, KW_STRIP, KW_SUBSCRIPTION, KW_SUBSTRING, KW_SUPPORT,
+    KW_SYMMETRIC, KW_SYSID, KW_SYSTEM, KW_SYSTEM_USER, KW_TABLE, KW_TABLES, KW_TABLESAMPLE,
+    KW_TABLESPACE, KW_TEMP, KW_TEMPLATE, KW_TEMPORARY, KW_TEXT, KW_THEN, KW_TIES, KW_TIME,
+    KW_TIMESTAMP, KW_TO, KW_TRAILING, KW_TRANSACTION, KW_TRANSFORM, KW_TREAT, KW_TRIGGER, KW_TRIM,
+    KW_TRUE, KW_TRUNCATE, KW_TRUSTED, KW_TYPE, KW_TYPES, KW_UESCAPE, KW_UNBOUNDED, KW_UNCOMMITTED,
+    KW_UNENCRYPTED, KW_UNION, KW_UNIQUE, KW_UNKNOWN, KW_UNLISTEN, KW_UNLOGGED, KW_UNTIL, KW_UPDATE,
+    KW_USER, KW_USING, KW_VACUUM, KW_VALID, KW_VALIDATE, KW_VALIDATOR, KW_VALUE, KW_VALUES,
+    KW_VARCHAR, KW_VARIADIC, KW_VARYING, KW_VERBOSE, KW_VERSION, KW_VIEW, KW_VIEWS, KW_VOLATILE,
+    KW_WHEN, KW_WHERE, KW_WHITESPACE, KW_WINDOW, KW_WITH, KW_WITHIN, KW_WITHOUT, KW_WORK,
+    KW_WRAPPER, KW_WRITE, KW_XML, KW_XMLATTRIBUTES, KW_XMLCONCAT, KW_XMLELEMENT, KW_XMLEXISTS,
+    KW_XMLFOREST, KW_XMLNAMESPACES, KW_XMLPARSE, KW_XMLPI, KW_XMLROOT, KW_XMLSERIALIZE,
+    KW_XMLTABLE, KW_YEAR, KW_YES, KW_ZONE,
+};
+
+struct SqlKeyword
+{
+    const char* name;
+    size_t length;
+    SqlKeywordCategory category;
+};
+
+const SqlKeyword SqlKeywords[] = {
+    { "abort", 5, UnreservedKeyword },
+    { "absent", 6, UnreservedKeyword },
+    { "absolute", 8, UnreservedKeyword },
+    { "access", 6, UnreservedKeyword },
+    { "action", 6, UnreservedKeyword },
+    { "add", 3, UnreservedKeyword },
+    { "admin", 5, UnreservedKeyword },
+    { "after", 5, UnreservedKeyword },
+    { "aggregate", 9, UnreservedKeyword },
+    { "all", 3, ReservedKeyword },
+    { "also", 4, UnreservedKeyword },
+    { "alter", 5, UnreservedKeyword },
+    { "always", 6, UnreservedKeyword },
+    { "analyse", 7, ReservedKeyword },
+    { "analyze", 7, ReservedKeyword },
+    { "and", 3, ReservedKeyword },
+    { "any", 3, ReservedKeyword },
+    { "array", 5, ReservedKeyword },
+    { "as", 2, ReservedKeyword },
+    { "asc", 3, ReservedKeyword },
+    { "asensitive", 10, UnreservedKeyword },
+    { "assertion", 9, UnreservedKeyword },
+    { "assignment", 10, UnreservedKeyword },
+    { "asymmetric", 10, ReservedKeyword },
+    { "at", 2, UnreservedKeyword },
+    { "atomic", 6, UnreservedKeyword },
+    { "attach", 6, UnreservedKeyword },
+    { "attribute", 9, UnreservedKeyword },
+    { "authorization", 13, TypeFuncNameKeyword },
+    { "backward", 8, UnreservedKeyword },
+    { "before", 6, UnreservedKeyword },
+    { "begin", 5, UnreservedKeyword },
+    { "between", 7, ColNameKeyword },
+    { "bigint", 6, ColNameKeyword },
+    { "binary", 6, TypeFuncNameKeyword },
+    { "bit", 3, ColNameKeyword },
+    { "boolean", 7, ColNameKeyword },
+    { "both", 4, ReservedKeyword },
+    { "breadth", 7, UnreservedKeyword },
+    { "by", 2, UnreservedKeyword },
+    { "cache", 5, UnreservedKeyword },
+    { "call", 4, UnreservedKeyword },
+    { "called", 6, UnreservedKeyword },
+    { "cascade", 7, UnreservedKeyword },
+    { "cascaded", 8, UnreservedKeyword },
+    { "case", 4, ReservedKeyword },
+    { "cast", 4, ReservedKeyword },
+    { "catalog", 7, UnreservedKeyword },
+    { "chain", 5, UnreservedKeyword },
+    { "char", 4, ColNameKeyword },
+    { "character", 9, ColNameKeyword },
+    { "characteristics", 15, UnreservedKeyword },
+    { "check", 5, ReservedKeyword },
+    { "checkpoint", 10, UnreservedKeyword },
+    { "class", 5, UnreservedKeyword },
+    { "close", 5, UnreservedKeyword },
+    { "cluster", 7, UnreservedKeyword },
+    { "coalesce", 8, ColNameKeyword },
+    { "collate", 7, ReservedKeyword },
+    { "collation", 9, TypeFuncNameKeyword },
+    { "column", 6, ReservedKeyword },
+    { "columns", 7, UnreservedKeyword },
+    { "comment", 7, UnreservedKeyword },
+    { "comments", 8, UnreservedKeyword },
+    { "commit", 6, UnreservedKeyword },
+    { "committed", 9, UnreservedKeyword },
+    { "compression", 11, UnreservedKeyword },
+    { "concurrently", 12, TypeFuncNameKeyword },
+    { "configuration", 13, UnreservedKeyword },
+    { "conflict", 8, UnreservedKeyword },
+    { "connection", 10, UnreservedKeyword },
+    { "constraint", 10, ReservedKeyword },
+    { "constraints", 11, UnreservedKeyword },
+    { "content", 7, UnreservedKeyword },
+    { "continue", 8, UnreservedKeyword },
+    { "conversion", 10, UnreservedKeyword },
+    { "copy", 4, UnreservedKeyword },
+    { "cost", 4, UnreservedKeyword },
+    { "create", 6, ReservedKeyword },
+    { "cross", 5, TypeFuncNameKeyword },
+    { "csv", 3, UnreservedKeyword },
+    { "cube", 4, UnreservedKeyword },
+    { "current", 7, UnreservedKeyword },
+    { "current_catalog", 15, ReservedKeyword },
+    { "current_date", 12, ReservedKeyword },
+    { "current_role", 12, ReservedKeyword },
+    { "current_schema", 14, TypeFuncNameKeyword },
+    { "current_time", 12, ReservedKeyword },
+    { "current_timestamp", 17, ReservedKeyword },
+    { "current_user", 12, ReservedKeyword },
+    { "cursor", 6, UnreservedKeyword },
+    { "cycle", 5, UnreservedKeyword },
+    { "data", 4, UnreservedKeyword },
+    { "database", 8, UnreservedKeyword },
+    { "day", 3, UnreservedKeyword },
+    { "deallocate", 10, UnreservedKeyword },
+    { "dec", 3, ColNameKeyword },
+    { "decimal", 7, ColNameKeyword },
+    { "declare", 7, UnreservedKeyword },
+    { "default", 7, ReservedKeyword },
+    { "defaults", 8, UnreservedKeyword },
+    { "deferrable", 10, ReservedKeyword },
+    { "deferred", 8, UnreservedKeyword },
+    { "definer", 7, UnreservedKeyword },
+    { "delete", 6, UnreservedKeyword },
+    { "delimiter", 9, UnreservedKeyword },
+    { "delimiters", 10, UnreservedKeyword },
+    { "depends", 7, UnreservedKeyword },
+    { "depth", 5, UnreservedKeyword },
+    { "desc", 4, ReservedKeyword },
+    { "detach", 6, UnreservedKeyword },
+    { "dictionary", 10, UnreservedKeyword },
+    { "disable", 7, UnreservedKeyword },
+    { "discard", 7, UnreservedKeyword },
+    { "distinct", 8, ReservedKeyword },
+    { "do", 2, ReservedKeyword },
+    { "document", 8, UnreservedKeyword },
+    { "domain", 6, UnreservedKeyword },
+    { "double", 6, UnreservedKeyword },
+    { "drop", 4, UnreservedKeyword },
+    { "each", 4, UnreservedKeyword },
+    { "else", 4, ReservedKeyword },
+    { "enable", 6, UnreservedKeyword },
+    { "encoding", 8, UnreservedKeyword },
+    { "encrypted", 9, UnreservedKeyword },
+    { "end", 3, ReservedKeyword },
+    { "enum", 4, UnreservedKeyword },
+    { "escape", 6, UnreservedKeyword },
+    { "event", 5, UnreservedKeyword },
+    { "except", 6, ReservedKeyword },
+    { "exclude", 7, UnreservedKeyword },
+    { "excluding", 9, UnreservedKeyword },
+    { "exclusive", 9, UnreservedKeyword },
+    { "execute", 7, UnreservedKeyword },
+    { "exists", 6, ColNameKeyword },
+    { "explain", 7, UnreservedKeyword },
+    { "expression", 10, UnreservedKeyword },
+    { "extension", 9, UnreservedKeyword },
+    { "external", 8, UnreservedKeyword },
+    { "extract", 7, ColNameKeyword },
+    { "false", 5, ReservedKeyword },
+    { "family", 6, UnreservedKeyword },
+    { "fetch", 5, ReservedKeyword },
+    { "filter", 6, UnreservedKeyword },
+    { "finalize", 8, UnreservedKeyword },
+    { "first", 5, UnreservedKeyword },
+    { "float", 5, ColNameKeyword },
+    { "following", 9, UnreservedKeyword },
+    { "for", 3, ReservedKeyword },
+    { "force", 5, UnreservedKeyword },
+    { "foreign", 7, ReservedKeyword },
+    { "format", 6, UnreservedKeyword },
+    { "forward", 7, UnreservedKeyword },
+    { "freeze", 6, TypeFuncNameKeyword },
+    { "from", 4, ReservedKeyword },
+    { "full", 4, TypeFuncNameKeyword },
+    { "function", 8, UnreservedKeyword },
+    { "functions", 9, UnreservedKeyword },
+    { "generated", 9, UnreservedKeyword },
+    { "global", 6, UnreservedKeyword },
+    { "grant", 5, ReservedKeyword },
+    { "granted", 7, UnreservedKeyword },
+    { "greatest", 8, ColNameKeyword },
+    { "group", 5, ReservedKeyword },
+    { "grouping", 8, ColNameKeyword },
+    { "groups", 6, UnreservedKeyword },
+    { "handler", 7, UnreservedKeyword },
+    { "having", 6, ReservedKeyword },
+    { "header", 6, UnreservedKeyword },
+    { "hold", 4, UnreservedKeyword },
+    { "hour", 4, UnreservedKeyword },
+    { "identity", 8, UnreservedKeyword },
+    { "if", 2, UnreservedKeyword },
+    { "ilike", 5, TypeFuncNameKeyword },
+    { "immediate", 9, UnreservedKeyword },
+    { "immutable", 9, UnreservedKeyword },
+    { "implicit", 8, UnreservedKeyword },
+    { "import", 6, UnreservedKeyword },
+    { "in", 2, ReservedKeyword },
+    { "include", 7, UnreservedKeyword },
+    { "including", 9, UnreservedKeyword },
+    { "increment", 9, UnreservedKeyword },
+    { "indent", 6, UnreservedKeyword },
+    { "index", 5, UnreservedKeyword },
+    { "indexes", 7, UnreservedKeyword },
+    { "inherit", 7, UnreservedKeyword },
+    { "inherits", 8, UnreservedKeyword },
+    { "initially", 9, ReservedKeyword },
+    { "inline", 6, UnreservedKeyword },
+    { "inner", 5, TypeFuncNameKeyword },
+    { "inout", 5, ColNameKeyword },
+    { "input", 5, UnreservedKeyword },
+    { "insensitive", 11, UnreservedKeyword },
+    { "insert", 6, UnreservedKeyword },
+    { "instead", 7, UnreservedKeyword },
+    { "int", 3, ColNameKeyword },
+    { "integer", 7, ColNameKeyword },
+    { "intersect", 9, ReservedKeyword },
+    { "interval", 8, ColNameKeyword },
+    { "into", 4, ReservedKeyword },
+    { "invoker", 7, UnreservedKeyword },
+    { "is", 2, TypeFuncNameKeyword },
+    { "isnull", 6, TypeFuncNameKeyword },
+    { "isolation", 9, UnreservedKeyword },
+    { "join", 4, TypeFuncNameKeyword },
+    { "json", 4, ColNameKeyword },
+    { "json_array", 10, ColNameKeyword },
+    { "json_arrayagg", 13, ColNameKeyword },
+    { "json_object", 11, ColNameKeyword },
+    { "json_objectagg", 14, ColNameKeyword },
+    { "key", 3, UnreservedKeyword },
+    { "keys", 4, UnreservedKeyword },
+    { "label", 5, UnreservedKeyword },
+    { "language", 8, UnreservedKeyword },
+    { "large", 5, UnreservedKeyword },
+    { "last", 4, UnreservedKeyword },
+    { "lateral", 7, ReservedKeyword },
+    { "leading", 7, ReservedKeyword },
+    { "leakproof", 9, UnreservedKeyword },
+    { "least", 5, ColNameKeyword },
+    { "left", 4, TypeFuncNameKeyword },
+    { "level", 5, UnreservedKeyword },
+    { "like", 4, TypeFuncNameKeyword },
+    { "limit", 5, ReservedKeyword },
+    { "listen", 6, UnreservedKeyword },
+    { "load", 4, UnreservedKeyword },
+    { "local", 5, UnreservedKeyword },
+    { "localtime", 9, ReservedKeyword },
+    { "localtimestamp", 14, ReservedKeyword },
+    { "location", 8, UnreservedKeyword },
+    { "lock", 4, UnreservedKeyword },
+    { "locked", 6, UnreservedKeyword },
+    { "logged", 6, UnreservedKeyword },
+    { "mapping", 7, UnreservedKeyword },
+    { "match", 5, UnreservedKeyword },
+    { "matched", 7, UnreservedKeyword },
+    { "materialized", 12, UnreservedKeyword },
+    { "maxvalue", 8, UnreservedKeyword },
+    { "merge", 5, UnreservedKeyword },
+    { "method", 6, UnreservedKeyword },
+    { "minute", 6, UnreservedKeyword },
+    { "minvalue", 8, UnreservedKeyword },
+    { "mode", 4, UnreservedKeyword },
+    { "month", 5, UnreservedKeyword },
+    { "move", 4, UnreservedKeyword },
+    { "name", 4, UnreservedKeyword },
+    { "names", 5, UnreservedKeyword },
+    { "national", 8, ColNameKeyword },
+    { "natural", 7, TypeFuncNameKeyword },
+    { "nchar", 5, ColNameKeyword },
+    { "new", 3, UnreservedKeyword },
+    { "next", 4, UnreservedKeyword },
+    { "nfc", 3, UnreservedKeyword },
+    { "nfd", 3, UnreservedKeyword },
+    { "nfkc", 4, UnreservedKeyword },
+    { "nfkd", 4, UnreservedKeyword },
+    { "no", 2, UnreservedKeyword },
+    { "none", 4, ColNameKeyword },
+    { "normalize", 9, ColNameKeyword },
+    { "normalized", 10, UnreservedKeyword },
+    { "not", 3, ReservedKeyword },
+    { "nothing", 7, UnreservedKeyword },
+    { "notify", 6, UnreservedKeyword },
+    { "notnull", 7, TypeFuncNameKeyword },
+    { "nowait", 6, UnreservedKeyword },
+    { "null", 4, ReservedKeyword },
+    { "nullif", 6, ColNameKeyword },
+    { "nulls", 5, UnreservedKeyword },
+    { "numeric", 7, ColNameKeyword },
+    { "object", 6, UnreservedKeyword },
+    { "of", 2, UnreservedKeyword },
+    { "off", 3, UnreservedKeyword },
+    { "offset", 6, ReservedKeyword },
+    { "oids", 4, UnreservedKeyword },
+    { "old", 3, UnreservedKeyword },
+    { "on", 2, ReservedKeyword },
+    { "only", 4, ReservedKeyword },
+    { "operator", 8, UnreservedKeyword },
+    { "option", 6, UnreservedKeyword },
+    { "options", 7, UnreservedKeyword },
+    { "or", 2, ReservedKeyword },
+    { "order", 5, ReservedKeyword },
+    { "ordinality", 10, UnreservedKeyword },
+    { "others", 6, UnreservedKeyword },
+    { "out", 3, ColNameKeyword },
+    { "outer", 5, TypeFuncNameKeyword },
+    { "over", 4, UnreservedKeyword },
+    { "overlaps", 8, TypeFuncNameKeyword },
+    { "overlay", 7, ColNameKeyword },
+    { "overriding", 10, UnreservedKeyword },
+    { "owned", 5, UnreservedKeyword },
+    { "owner", 5, UnreservedKeyword },
+    { "parallel", 8, UnreservedKeyword },
+    { "parameter", 9, UnreservedKeyword },
+    { "parser", 6, UnreservedKeyword },
+    { "partial", 7, UnreservedKeyword },
+    { "partition", 9, UnreservedKeyword },
+    { "passing", 7, UnreservedKeyword },
+    { "password", 8, UnreservedKeyword },
+    { "placing", 7, ReservedKeyword },
+    { "plans", 5, UnreservedKeyword },
+    { "policy", 6, UnreservedKeyword },
+    { "position", 8, ColNameKeyword },
+    { "preceding", 9, UnreservedKeyword },
+    { "precision", 9, ColNameKeyword },
+    { "prepare", 7, UnreservedKeyword },
+    { "prepared", 8, UnreservedKeyword },
+    { "preserve", 8, UnreservedKeyword },
+    { "primary", 7, ReservedKeyword },
+    { "prior", 5, UnreservedKeyword },
+    { "privileges", 10, UnreservedKeyword },
+    { "procedural", 10, UnreservedKeyword },
+    { "procedure", 9, UnreservedKeyword },
+    { "procedures", 10, UnreservedKeyword },
+    { "program", 7, UnreservedKeyword },
+    { "publication", 11, UnreservedKeyword },
+    { "quote", 5, UnreservedKeyword },
+    { "range", 5, UnreservedKeyword },
+    { "read", 4, UnreservedKeyword },
+    { "real", 4, ColNameKeyword },
+    { "reassign", 8, UnreservedKeyword },
+    { "recheck", 7, UnreservedKeyword },
+    { "recursive", 9, UnreservedKeyword },
+    { "ref", 3, UnreservedKeyword },
+    { "references", 10, ReservedKeyword },
+    { "referencing", 11, UnreservedKeyword },
+    { "refresh", 7, UnreservedKeyword },
+    { "reindex", 7, UnreservedKeyword },
+    { "relative", 8, UnreservedKeyword },
+    { "release", 7, UnreservedKeyword },
+    { "rename", 6, UnreservedKeyword },
+    { "repeatable", 10, UnreservedKeyword },
+    { "replace", 7, UnreservedKeyword },
+    { "replica", 7, UnreservedKeyword },
+    { "reset", 5, UnreservedKeyword },
+    { "restart", 7, UnreservedKeyword },
+    { "restrict", 8, UnreservedKeyword },
+    { "return", 6, UnreservedKeyword },
+    { "returning", 9, ReservedKeyword },
+    { "returns", 7, UnreservedKeyword },
+    { "revoke", 6, UnreservedKeyword },
+    { "right", 5, TypeFuncNameKeyword },
+    { "role", 4, UnreservedKeyword },
+    { "rollback", 8, UnreservedKeyword },
+    { "rollup", 6, UnreservedKeyword },
+    { "routine", 7, UnreservedKeyword },
+    { "routines", 8, UnreservedKeyword },
+    { "row", 3, ColNameKeyword },
+    { "rows", 4, UnreservedKeyword },
+    { "rule", 4, UnreservedKeyword },
+    { "savepoint", 9, UnreservedKeyword },
+    { "scalar", 6, UnreservedKeyword },
+    { "schema", 6, UnreservedKeyword },
+    { "schemas", 7, UnreservedKeyword },
+    { "scroll", 6, UnreservedKeyword },
+    { "search", 6, UnreservedKeyword },
+    { "second", 6, UnreservedKeyword },
+    { "security", 8, UnreservedKeyword },
+    { "select", 6, ReservedKeyword },
+    { "sequence", 8, UnreservedKeyword },
+    { "sequences", 9, UnreservedKeyword },
+    { "serializable", 12, UnreservedKeyword },
+    { "server", 6, UnreservedKeyword },
+    { "session", 7, UnreservedKeyword },
+    { "session_user", 12, ReservedKeyword },
+    { "set", 3, UnreservedKeyword },
+    { "setof", 5, ColNameKeyword },
+    { "sets", 4, UnreservedKeyword },
+    { "share", 5, UnreservedKeyword },
+    { "show", 4, UnreservedKeyword },
+    { "similar", 7, TypeFuncNameKeyword },
+    { "simple", 6, UnreservedKeyword },
+    { "skip", 4, UnreservedKeyword },
+    { "smallint", 8, ColNameKeyword },
+    { "snapshot", 8, UnreservedKeyword },
+    { "some", 4, ReservedKeyword },
+    { "sql", 3, UnreservedKeyword },
+    { "stable", 6, UnreservedKeyword },
+    { "standalone", 10, UnreservedKeyword },
+    { "start", 5, UnreservedKeyword },
+    { "statement", 9, UnreservedKeyword },
+    { "statistics", 10, UnreservedKeyword },
+    { "stdin", 5, UnreservedKeyword },
+    { "stdout", 6, UnreservedKeyword },
+    { "storage", 7, UnreservedKeyword },
+    { "stored", 6, UnreservedKeyword },
+    { "strict", 6, UnreservedKeyword },
+    { "strip", 5, UnreservedKeyword },
+    { "subscription", 12, UnreservedKeyword },
+    { "substring", 9, ColNameKeyword },
+    { "support", 7, UnreservedKeyword },
+    { "symmetric", 9, ReservedKeyword },
+    { "sysid", 5, UnreservedKeyword },
+    { "system", 6, UnreservedKeyword },
+    { "system_user", 11, ReservedKeyword },
+    { "table", 5, ReservedKeyword },
+    { "tables", 6, UnreservedKeyword },
+    { "tablesample", 11, TypeFuncNameKeyword },
+    { "tablespace", 10, UnreservedKeyword },
+    { "temp", 4, UnreservedKeyword },
+    { "template", 8, UnreservedKeyword },
+    { "temporary", 9, UnreservedKeyword },
+    { "text", 4, UnreservedKeyword },
+    { "then", 4, ReservedKeyword },
+    { "ties", 4, UnreservedKeyword },
+    { "time", 4, ColNameKeyword },
+    { "timestamp", 9, ColNameKeyword },
+    { "to", 2, ReservedKeyword },
+    { "trailing", 8, ReservedKeyword },
+    { "transaction", 11, UnreservedKeyword },
+    { "transform", 9, UnreservedKeyword },
+    { "treat", 5, ColNameKeyword },
+    { "trigger", 7, UnreservedKeyword },
+    { "trim", 4, ColNameKeyword },
+    { "true", 4, ReservedKeyword },
+    { "truncate", 8, UnreservedKeyword },
+    { "trusted", 7, UnreservedKeyword },
+    { "type", 4, UnreservedKeyword },
+    { "types", 5, UnreservedKeyword },
+    { "uescape", 7, UnreservedKeyword },
+    { "unbounded", 9, UnreservedKeyword },
+    { "uncommitted", 11, UnreservedKeyword },
+    { "unencrypted", 11, UnreservedKeyword },
+    { "union", 5, ReservedKeyword },
+    { "unique", 6, ReservedKeyword },
+    { "unknown", 7, UnreservedKeyword },
+    { "unlisten", 8, UnreservedKeyword },
+    { "unlogged", 8, UnreservedKeyword },
+    { "until", 5, UnreservedKeyword },
+    { "update", 6, UnreservedKeyword },
+    { "user", 4, ReservedKeyword },
+    { "using", 5, ReservedKeyword },
+    { "vacuum", 6, UnreservedKeyword },
+    { "valid", 5, UnreservedKeyword },
+    { "validate", 8, UnreservedKeyword },
+    { "validator", 9, UnreservedKeyword },
+    { "value", 5, UnreservedKeyword },
+    { "values", 6, ColNameKeyword },
+    { "varchar", 7, ColNameKeyword },
+    { "variadic", 8, ReservedKeyword },
+    { "varying", 7, UnreservedKeyword },
+    { "verbose", 7, TypeFuncNameKeyword },
+    { "version", 7, UnreservedKeyword },
+    { "view", 4, UnreservedKeyword },
+    { "views", 5, UnreservedKeyword },
+    { "volatile", 8, UnreservedKeyword },
+    { "when", 4, ReservedKeyword },
+    { "where", 5, ReservedKeyword },
+    { "whitespace", 10, UnreservedKeyword },
+    { "window", 6, ReservedKeyword },
+    { "with", 4, ReservedKeyword },
+    { "within", 6, UnreservedKeyword },
+    { "without", 7, UnreservedKeyword },
+    { "work", 4, UnreservedKeyword },
+    { "wrapper", 7, UnreservedKeyword },
+    { "write", 5, UnreservedKeyword },
+    { "xml", 3, UnreservedKeyword },
+    { "xmlattributes", 13, ColNameKeyword },
+    { "xmlconcat", 9, ColNameKeyword },
+    { "xmlelement", 10, ColNameKeyword },
+    { "xmlexists", 9, ColNameKeyword },
+    { "xmlforest", 9, ColNameKeyword },
+    { "xmlnamespaces", 13, ColNameKeyword },
+    { "xmlparse", 8, ColNameKeyword },
+    { "xmlpi", 5, ColNameKeyword },
+    { "xmlroot", 7, ColNameKeyword },
+    { "xmlserialize", 12, ColNameKeyword },
+    { "xmltable", 8, ColNameKeyword },
+    { "year", 4, UnreservedKeyword },
+    { "yes", 3, UnreservedKeyword },
+    { "zone", 4, UnreservedKeyword },
+};
+
+const size_t SqlKeywordCount = 471;
+const size_t SqlKeywordMaxLength = 17;
+
+// Perfect hash: index = (table[h1 % size] + table[h2 % size]) % count
+// h = h * multiplier + character, starting from seed (h1) and seed + 1 (h2)
+const uint32_t SqlKeywordHashMultiplier1 = 31;
+const uint32_t SqlKeywordHashMultiplier2 = 127;
+const uint32_t SqlKeywordHashSeed = 1;
+const uint32_t SqlKeywordHashSize = 943;
+
+const uint16_t SqlKeywordHashTable[] = {
+    0, 0, 0, 0, 0, 0, 0, 350, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 247, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 141, 0, 0, 0, 0, 0,
+    0, 0, 0, 206, 0, 150, 0, 262, 0, 0, 176, 47, 74, 0, 234, 0, 0, 76, 189, 83, 0, 0, 0, 0, 0, 0,
+    0, 0, 435, 142, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 408, 0, 160, 0, 0, 79, 0, 331, 75, 0, 0, 0, 57,
+    328, 0, 0, 0, 0, 0, 121, 0, 0, 0, 0, 0, 0, 0, 0, 273, 320, 228, 0, 0, 0, 0, 440, 0, 0, 0, 0, 0,
+    250, 236, 0, 228, 0, 428, 0, 344, 0, 462, 0, 0, 0, 189, 161, 388, 0, 0, 0, 0, 0, 290, 0, 0, 0,
+    0, 0, 0, 124, 468, 180, 359, 0, 0, 0, 0, 375, 0, 0, 0, 0, 224, 0, 50, 233, 0, 301, 0, 0, 265,
+    93, 0, 0, 0, 0, 0, 0, 121, 99, 186, 413, 466, 233, 451, 0, 8, 0, 164, 0, 124, 0, 0, 0, 0, 160,
+    0, 365, 69, 0, 0, 366, 185, 431, 22, 41, 0, 268, 0, 0, 271, 244, 430, 21, 0, 0, 0, 0, 0, 0,
+    158, 267, 0, 0, 0, 186, 429, 131, 284, 0, 0, 396, 0, 0, 0, 0, 160, 0, 359, 0, 0, 0, 98, 0, 0,
+    240, 0, 0, 92, 0, 466, 188, 396, 0, 0, 0, 395, 32, 0, 0, 70, 254, 255, 34, 198, 259, 0, 137,
+    38, 150, 0, 413, 0, 0, 423, 0, 47, 0, 0, 141, 70, 391, 0, 280, 188, 0, 409, 0, 0, 0, 19, 184,
+    0, 265, 237, 0, 236, 0, 0, 0, 0, 0, 0, 135, 6, 0, 0, 0, 38, 0, 237, 67, 364, 140, 0, 100, 452,
+    95, 246, 0, 20, 0, 0, 283, 340, 293, 307, 0, 212, 176, 85, 0, 318, 0, 246, 470, 100, 0, 0, 402,
+    107, 192, 409, 0, 0, 297, 0, 0, 0, 0, 0, 305, 24, 0, 0, 98, 0, 87, 0, 200, 0, 0, 0, 205, 0,
+    374, 387, 363, 0, 0, 21, 100, 0, 24, 0, 0, 112, 0, 58, 422, 0, 347, 0, 0, 0, 0, 404, 0, 87,
+    147, 440, 256, 312, 146, 298, 396, 144, 229, 0, 0, 347, 0, 359, 179, 0, 411, 0, 0, 0, 0, 432,
+    41, 97, 0, 44, 256, 0, 197, 441, 390, 0, 0, 259, 269, 451, 195, 214, 0, 284, 26, 215, 0, 319,
+    70, 400, 222, 0, 101, 0, 162, 0, 313, 0, 155, 0, 0, 266, 0, 110, 79, 272, 0, 0, 100, 0, 0, 0,
+    199, 44, 0, 0, 64, 0, 0, 0, 0, 273, 349, 198, 167, 0, 0, 0, 0, 0, 38, 379, 297, 0, 208, 0, 233,
+    0, 0, 298, 238, 207, 0, 0, 0, 368, 0, 427, 0, 174, 0, 0, 0, 100, 0, 387, 0, 372, 122, 43, 22,
+    303, 77, 0, 371, 0, 0, 0, 0, 216, 0, 404, 0, 418, 114, 311, 0, 315, 47, 153, 0, 131, 0, 63,
+    168, 438, 0, 151, 0, 259, 0, 353, 0, 0, 221, 0, 0, 405, 0, 55, 224, 0, 229, 0, 0, 0, 452, 366,
+    0, 462, 0, 267, 4, 0, 441, 147, 420, 327, 56, 0, 0, 115, 36, 0, 0, 0, 0, 0, 20, 0, 0, 0, 98,
+    119, 224, 306, 0, 0, 257, 154, 318, 330, 0, 0, 450, 0, 0, 192, 319, 410, 0, 0, 220, 0, 0, 0,
+    45, 0, 61, 456, 0, 70, 0, 0, 429, 157, 321, 2, 17, 0, 0, 0, 0, 446, 0, 143, 149, 427, 424, 310,
+    0, 85, 111, 446, 0, 0, 0, 350, 368, 433, 177, 463, 0, 308, 360, 0, 334, 126, 374, 171, 261,
+    358, 48, 0, 284, 194, 0, 455, 0, 0, 0, 0, 0, 450, 118, 0, 407, 68, 0, 0, 0, 387, 0, 1, 146, 0,
+    0, 0, 0, 299, 226, 455, 17, 418, 368, 0, 13, 397, 330, 0, 316, 351, 451, 0, 0, 256, 316, 0,
+    180, 386, 439, 0, 63, 53, 0, 0, 403, 5, 0, 4, 295, 0, 0, 0, 297, 201, 0, 270, 452, 0, 165, 235,
+    462, 0, 56, 387, 0, 470, 183, 182, 0, 116, 0, 115, 361, 22, 0, 454, 0, 0, 6, 445, 0, 276, 41,
+    424, 179, 298, 444, 404, 67, 135, 125, 83, 0, 62, 0, 336, 49, 414, 348, 0, 0, 214, 421, 412, 0,
+    326, 373, 451, 0, 0, 0, 108, 5, 304, 255, 0, 406, 159, 0, 356, 35, 351, 0, 0, 460, 0, 261, 54,
+    196, 298, 0, 0, 0, 296, 447, 0, 112, 4, 72, 116, 101, 0, 7, 0, 0, 96, 225, 23, 0, 325, 0, 0,
+    460, 0, 0, 446, 320, 128, 0, 51, 76, 0, 0, 0, 0, 0, 0, 0, 0, 345, 324, 198, 63, 444, 384, 0, 0,
+    114, 194, 14, 292, 0, 0, 341, 88, 391, 411, 94, 371, 356, 455, 0, 182, 0, 0, 191, 457, 407, 0,
+    17, 0, 470, 429, 0, 428, 0, 64, 0, 0, 329, 0, 0, 188, 0, 0, 0, 77, 243, 0, 164, 0, 0, 348, 90,
+    371, 0, 123, 389, 0, 0, 210, 251, 0, 0, 0, 402, 0, 436, 123, 0, 419, 261, 294, 245, 358, 0, 0,
+    174, 94, 401, 469, 307, 0, 0, 0, 0, 459, 371, 0, 271, 49, 181, 0, 0, 0, 439,
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SQL_KEYWORDS_H
+#define SQL_KEYWORDS_H
+
+#include <cstring>
+#include "sql_keyword_table.h"
+
+// SQL keyword lookup
+// Keywords and their categories are listed in tools/sql_keywords.txt,
+// sql_keyword_table.h with minimal perfect hash is generated from it.
+// Lookup is case insensitive (A-Z only) and works for narrow and wide
+// words: both hashes are computed in one pass over the word, then the
+// only candidate keyword is compared with it.
+
+// Returns token id (SqlKeywordToken) of word or -1 if it is not a keyword
+template<typename Char>
+int sqlKeywordLookup(const Char* word, size_t length)
+{
+    if (length == 0 || length > SqlKeywordMaxLength) return -1;
+    char folded[SqlKeywordMaxLength];
+    uint32_t hash1 = SqlKeywordHashSeed;
+    uint32_t hash2 = SqlKeywordHashSeed + 1;
+    for (size_t i = 0; i < length; ++i) {
+        uint32_t c = static_cast<uint32_t>(word[i]);
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        else if (c > 0x7F) return -1;
+        folded[i] = static_cast<char>(c);
+        hash1 = hash1 * SqlKeywordHashMultiplier1 + c;
+        hash2 = hash2 * SqlKeywordHashMultiplier2 + c;
+    }
+    uint32_t index = (static_cast<uint32_t>(SqlKeywordHashTable[hash1 % SqlKeywordHashSize])
+        + SqlKeywordHashTable[hash2 % SqlKeywordHashSize]) % SqlKeywordCount;
+    const SqlKeyword& keyword = SqlKeywords[index];
+    if (keyword.length != length || memcmp(keyword.name, folded, length) != 0) return -1;
+    return static_cast<int>(index);
+}
+
+// Checks if word can not be used as unquoted identifier
+// (it is a keyword of other category than unreserved)
+template<typename Char>
+bool isSqlKeyword(const Char* word, size_t length)
+{
+    int token = sqlKeywordLookup(word, length);
+    return token >= 0 && SqlKeywords[token].category != UnreservedKeyword;
+}
+
+#endif
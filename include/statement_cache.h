@@ -0,0 +1,235 @@
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "flat_list.h"
+#include "parse_cache_file.h"
+
+// In-memory cache of prepared statement parse trees
+// Every tree is kept as a flat list block (flat_list.h),
+// the block is its own memory context: one allocation,
+// immutable and with exact size known for the budget.
+// Lookups return shared read-only handles, so executing
+// statement never copies the tree and keeps it alive
+// even if it is evicted meanwhile.
+
+struct CachedParseTree
+{
+    explicit CachedParseTree(std::vector<char> b)
+        :block(std::move(b)), view(FlatListView::fromBuffer(block.data(), block.size())) {}
+    const FlatListView& tree() const { return view; }
+    size_t size() const { return block.size(); }
+private:
+    CachedParseTree(const CachedParseTree&);
+    CachedParseTree& operator=(const CachedParseTree&);
+    std::vector<char> block;
+    FlatListView view;
+};
+
+typedef std::shared_ptr<const CachedParseTree> CachedParseTreeHandle;
+
+struct StatementCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;
+};
+
+// Thread safe cache limited by memory budget (in bytes)
+// Keyed by statement kind (T_PrepareStmt / T_ExecuteStmt) and text
+// Entries are spread over shards by key hash. Lookup takes shared lock
+// of one shard only and marks the entry as referenced, so concurrent
+// hits do not serialize on a global lock or reorder any list.
+// Eviction is CLOCK (second chance): entries are kept in a ring, the
+// hand clears reference marks of entries it passes and evicts the first
+// one not used since the previous pass. Inserts, deallocations and
+// evictions are serialized by the ring lock.
+struct StatementCache
+{
+    static const size_t ShardCount = 16;
+
+    explicit StatementCache(size_t budgetBytes) :budget(budgetBytes), bytes(0), insertions(0), evictions(0), hand(clock.end()) {}
+
+    // Stores tree of a statement and returns handle to it
+    // Tree bigger than whole budget is not retained
+    CachedParseTreeHandle insert(NodeTag kind, const std::wstring& text, const List& tree)
+    {
+        checkKind(kind);
+        auto handle = std::make_shared<const CachedParseTree>(flattenList(tree));
+        size_t charge = entryCharge(text, *handle);
+        Key key(kind, text);
+
+        std::lock_guard<std::mutex> lock(clockMutex);
+        removeEntry(key);
+        if (charge > budget) return handle;
+        // new entry is the last one the hand gets to
+        auto entry = clock.emplace(hand, key, handle, charge);
+        {
+            Shard& shard = shardOf(key);
+            std::unique_lock<std::shared_timed_mutex> shardLock(shard.mutex);
+            shard.entries.emplace(key, entry);
+        }
+        bytes += charge;
+        ++insertions;
+        evict();
+        return handle;
+    }
+
+    // Returns cached tree or nullptr
+    CachedParseTreeHandle lookup(NodeTag kind, const std::wstring& text)
+    {
+        Key key(kind, text);
+        Shard& shard = shardOf(key);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        Entry& entry = *it->second;
+        // avoid writing the shared line when the mark is already set
+        if (!entry.referenced.load(std::memory_order_relaxed)) entry.referenced.store(true, std::memory_order_relaxed);
+        return entry.tree;
+    }
+
+    // Drops statement from cache (T_DeallocateStmt)
+    bool deallocate(NodeTag kind, const std::wstring& text)
+    {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        return removeEntry(Key(kind, text));
+    }
+
+    void setBudget(size_t budgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        budget = budgetBytes;
+        evict();
+    }
+
+    StatementCacheStats stats()
+    {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        StatementCacheStats result{ 0, 0, insertions, evictions, clock.size(), bytes };
+        for (auto& shard : shards) {
+            result.hits += shard.hits.load(std::memory_order_relaxed);
+            result.misses += shard.misses.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    StatementCache(const StatementCache&);
+    StatementCache& operator=(const StatementCache&);
+
+    typedef std::pair<NodeTag, std::wstring> Key;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return static_cast<size_t>(statementHash(key.second.data(), key.second.size()) ^ static_cast<uint64_t>(key.first));
+        }
+    };
+
+    struct Entry
+    {
+        Entry(const Key& k, CachedParseTreeHandle t, size_t c) :key(k), tree(std::move(t)), charge(c), referenced(false) {}
+        Key key;
+        CachedParseTreeHandle tree;
+        size_t charge;
+        // set by lookups, cleared by the clock hand
+        std::atomic<bool> referenced;
+    };
+
+    typedef std::list<Entry> Clock;
+
+    struct Shard
+    {
+        Shard() :hits(0), misses(0) {}
+        std::shared_timed_mutex mutex;
+        std::unordered_map<Key, Clock::iterator, KeyHash> entries;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+    };
+
+    Shard shards[ShardCount];
+    // ring of all entries, nodes are changed under clockMutex only,
+    // lookups read entries through shard maps
+    std::mutex clockMutex;
+    size_t budget;
+    size_t bytes;
+    uint64_t insertions;
+    uint64_t evictions;
+    Clock clock;
+    Clock::iterator hand;
+
+    static void checkKind(NodeTag kind)
+    {
+        if (kind != T_PrepareStmt && kind != T_ExecuteStmt)
+            throw std::invalid_argument("statement cache: unsupported statement kind");
+    }
+
+    static size_t entryCharge(const std::wstring& text, const CachedParseTree& tree)
+    {
+        return tree.size() + sizeof(wchar_t) * text.size() + sizeof(Entry);
+    }
+
+    Shard& shardOf(const Key& key)
+    {
+        return shards[KeyHash()(key) % ShardCount];
+    }
+
+    // Removes entry from its shard and from the ring
+    void unlink(Clock::iterator entry)
+    {
+        {
+            Shard& shard = shardOf(entry->key);
+            std::unique_lock<std::shared_timed_mutex> shardLock(shard.mutex);
+            shard.entries.erase(entry->key);
+        }
+        if (hand == entry) ++hand;
+        bytes -= entry->charge;
+        clock.erase(entry);
+    }
+
+    bool removeEntry(const Key& key)
+    {
+        Clock::iterator entry;
+        {
+            Shard& shard = shardOf(key);
+            std::shared_lock<std::shared_timed_mutex> shardLock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) return false;
+            entry = it->second;
+        }
+        unlink(entry);
+        return true;
+    }
+
+    void evict()
+    {
+        while (bytes > budget && !clock.empty()) {
+            if (hand == clock.end()) hand = clock.begin();
+            if (hand->referenced.load(std::memory_order_relaxed)) {
+                hand->referenced.store(false, std::memory_order_relaxed);
+                ++hand;
+                continue;
+            }
+            unlink(hand++);
+            ++evictions;
+        }
+    }
+};
+
+#endif
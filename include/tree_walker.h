@@ -0,0 +1,290 @@
+#ifndef TREE_WALKER_H
+#define TREE_WALKER_H
+
+#include <stdexcept>
+#include <vector>
+#include "list_tools.h"
+
+// Generic tree walker and mutator
+// (equivalents of PG's expression_tree_walker / expression_tree_mutator)
+// Children of a node are found by its NodeTag (nodeChildren):
+// T_List contains nodes; Idents, T_IntList and T_OidList are leaves.
+// Nodes of other tags have no structure defined in this library,
+// walking them throws std::invalid_argument instead of skipping them.
+// Both use explicit stack instead of recursion, so depth of the tree
+// is not limited by call stack. Stack can be reused between calls
+// to avoid reallocations.
+
+// Value returned by walker function
+enum TreeWalkAction
+{
+    WalkContinue,      // go into children of the node
+    WalkSkipChildren,  // do not visit children of the node
+    WalkStop           // finish walking
+};
+
+// Kind of children of a node
+enum NodeChildren
+{
+    NodeNoChildren,    // leaf node
+    NodeListChildren   // elements of the list are child nodes
+};
+
+// Returns kind of children of a node by its NodeTag
+NodeChildren nodeChildren(const Node* node)
+{
+    switch (node->type) {
+    case T_List:
+        return NodeListChildren;
+    case T_IntList:
+    case T_OidList:
+    case T_Ident:
+    case T_IdentView:
+    case T_IdentEncoded:
+        return NodeNoChildren;
+    default:
+        throw std::invalid_argument("tree walker: unsupported node tag");
+    }
+}
+
+// Returns true if node has child nodes
+bool hasChildNodes(const Node* node)
+{
+    return nodeChildren(node) == NodeListChildren;
+}
+
+// Reusable stack for walkTree
+struct TreeWalkStack
+{
+    std::vector<ListCell*> cells;
+};
+
+// Visits all nodes in pre-order, walker is called as
+// TreeWalkAction walker(Node* node)
+// Returns false if walking was stopped by walker
+template<typename Walker>
+bool walkTree(Node* root, Walker walker, TreeWalkStack& stack)
+{
+    auto& cells = stack.cells;
+    cells.clear();
+
+    TreeWalkAction action = walker(root);
+    if (action == WalkStop) return false;
+    if (action == WalkSkipChildren || !hasChildNodes(root)) return true;
+    cells.push_back(static_cast<List*>(root)->head);
+
+    while (!cells.empty()) {
+        ListCell* cell = cells.back();
+        if (!cell) {
+            cells.pop_back();
+            continue;
+        }
+        cells.back() = cell->next;
+
+        Node* node = castNode<Node>(cell);
+        action = walker(node);
+        if (action == WalkStop) return false;
+        if (action == WalkContinue && hasChildNodes(node)) {
+            cells.push_back(static_cast<List*>(node)->head);
+        }
+    }
+    return true;
+}
+
+template<typename Walker>
+bool walkTree(Node* root, Walker walker)
+{
+    TreeWalkStack stack;
+    return walkTree(root, walker, stack);
+}
+
+// Reusable stack for mutateTree
+struct TreeMutateStack
+{
+    struct Frame
+    {
+        List* list;      // original list
+        ListCell* cell;  // next cell to process
+        List* copy;      // copy of the list, created on first changed child
+    };
+    std::vector<Frame> frames;
+};
+
+// Result of mutateTree
+// Owns lists created by mutateTree (copies of lists on the path to
+// changed nodes), they are cleaned and deleted together with the result.
+// Nodes returned by mutator stay owned by the caller and nodes of input
+// tree are shared by pointer, so both have to outlive the result.
+struct MutatedTree
+{
+    Node* root;
+    std::vector<List*> lists;
+
+    MutatedTree() :root(nullptr) {}
+    MutatedTree(MutatedTree&& other) :root(other.root), lists(std::move(other.lists)) { other.lists.clear(); }
+    MutatedTree& operator=(MutatedTree&& other)
+    {
+        if (this != &other) {
+            freeLists();
+            root = other.root;
+            lists.swap(other.lists);
+        }
+        return *this;
+    }
+    ~MutatedTree() { freeLists(); }
+
+    // Gives up ownership of created lists, caller releases them
+    std::vector<List*> release()
+    {
+        std::vector<List*> released;
+        released.swap(lists);
+        return released;
+    }
+
+private:
+    MutatedTree(const MutatedTree&);
+    MutatedTree& operator=(const MutatedTree&);
+
+    void freeLists()
+    {
+        for (auto list : lists) {
+            clean(*list);
+            delete list;
+        }
+        lists.clear();
+    }
+};
+
+// Policies of list copies created by mutateTree
+// PlainListCopy shares nodes of input tree by pointer, copies are owned
+// by MutatedTree, SharedListCopy creates SharedList and takes reference
+// to each shared node, copies are owned by references
+struct PlainListCopy
+{
+    static List* makeCopy() { return makeListHeap().release(); }
+    static Node* share(Node* node) { return node; }
+    static void keep(List* copy, MutatedTree& tree) { tree.lists.push_back(copy); }
+    static void discard(List* copy) { clean(*copy); delete copy; }
+};
+
+struct SharedListCopy
+{
+    static List* makeCopy() { return makeSharedList(); }
+    static Node* share(Node* node) { return retainNode(node); }
+    static void keep(List*, MutatedTree&) {}
+    static void discard(List* copy) { releaseNode(copy); }
+};
+
+// Mutates tree in post-order, mutator is called as
+// Node* mutator(Node* node)
+// and returns node that replaces given one (or node itself if unchanged).
+// Lists are passed to mutator after their children.
+// Input tree is never modified, only lists on the path
+// to changed nodes are copied (copy-on-write), all other subtrees
+// are shared between input and result tree.
+// Result owns new lists (see MutatedTree), caller owns replaced nodes.
+// List copy replaced by mutator is discarded.
+template<typename CopyPolicy = PlainListCopy, typename Mutator>
+MutatedTree mutateTree(Node* root, Mutator mutator, TreeMutateStack& stack)
+{
+    auto& frames = stack.frames;
+    frames.clear();
+
+    MutatedTree tree;
+    if (!hasChildNodes(root)) {
+        tree.root = mutator(root);
+        return tree;
+    }
+    List* rootList = static_cast<List*>(root);
+    frames.push_back({ rootList, rootList->head, nullptr });
+
+    // stores result of child node in the frame of its parent list
+    auto childDone = [](TreeMutateStack::Frame& frame, Node* result) {
+        Node* original = castNode<Node>(frame.cell);
+        if (result != original && !frame.copy) {
+            frame.copy = CopyPolicy::makeCopy();
+            frame.copy->type = frame.list->type;
+            for (ListCell* cell = frame.list->head; cell != frame.cell; cell = cell->next) {
+                push_back(*frame.copy, CopyPolicy::share(castNode<Node>(cell)));
+            }
+        }
+        if (frame.copy) push_back(*frame.copy, result == original ? CopyPolicy::share(original) : result);
+        frame.cell = frame.cell->next;
+    };
+
+    while (true) {
+        auto& frame = frames.back();
+        if (!frame.cell) {
+            Node* list = frame.copy ? frame.copy : frame.list;
+            Node* result = mutator(list);
+            if (frame.copy) {
+                if (result == list) CopyPolicy::keep(frame.copy, tree);
+                else CopyPolicy::discard(frame.copy);
+            }
+            frames.pop_back();
+            if (frames.empty()) {
+                tree.root = result;
+                return tree;
+            }
+            childDone(frames.back(), result);
+            continue;
+        }
+
+        Node* node = castNode<Node>(frame.cell);
+        if (hasChildNodes(node)) {
+            List* list = static_cast<List*>(node);
+            frames.push_back({ list, list->head, nullptr });
+        }
+        else {
+            childDone(frame, mutator(node));
+        }
+    }
+}
+
+template<typename CopyPolicy = PlainListCopy, typename Mutator>
+MutatedTree mutateTree(Node* root, Mutator mutator)
+{
+    TreeMutateStack stack;
+    return mutateTree<CopyPolicy>(root, mutator, stack);
+}
+
+// Mutates tree built from shared nodes
+// Mutator returns given node or a new reference that replaces it.
+// Result is a new reference: shared lists on the path to changed nodes
+// are copied and untouched subtrees are shared with input tree,
+// both trees are released independently with releaseNode.
+template<typename Mutator>
+Node* mutateSharedTree(Node* root, Mutator mutator, TreeMutateStack& stack)
+{
+    Node* result = mutateTree<SharedListCopy>(root, mutator, stack).root;
+    return result == root ? retainNode(root) : result;
+}
+
+template<typename Mutator>
+Node* mutateSharedTree(Node* root, Mutator mutator)
+{
+    TreeMutateStack stack;
+    return mutateSharedTree(root, mutator, stack);
+}
+
+// Deletes all nodes of a tree including root,
+// lists of any tag are cleaned before deletion
+// Tree must not share subtrees with other trees
+void freeTree(Node* root)
+{
+    std::vector<Node*> nodes;
+    walkTree(root, [&](Node* node) {
+        nodes.push_back(node);
+        return WalkContinue;
+    });
+    // children are after their parents, free them first
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        NodeTag tag = (*it)->type;
+        if (tag == T_List || tag == T_IntList || tag == T_OidList) {
+            clean(*static_cast<List*>(*it));
+        }
+        delete *it;
+    }
+}
+
+#endif
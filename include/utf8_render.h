@@ -0,0 +1,135 @@
+#ifndef UTF8_RENDER_H
+#define UTF8_RENDER_H
+
+#include <string>
+#include <vector>
+#include "list_tools.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define UTF8_RENDER_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Rendering of Ident lists directly to UTF-8
+// Wide names are transcoded while they are appended: runs of ASCII
+// characters are packed to bytes 16 at a time (AVX2 or SSE2),
+// other characters are encoded one by one. Encoded Idents (UTF-8, ASCII)
+// are copied as they are. Invalid code points become U+FFFD.
+
+// Packs 16 wchar_t to out if all of them are ASCII
+// Returns false (nothing written) otherwise
+bool packAscii16(const wchar_t* text, unsigned char* out)
+{
+#if defined(__AVX2__)
+    if (sizeof(wchar_t) == 4) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + 8));
+        if (!_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_set1_epi32(~0x7F))) return false;
+        // packs work within 128-bit lanes, permutation restores the order
+        __m256i words = _mm256_packs_epi32(low, high);
+        __m256i bytes = _mm256_packus_epi16(words, words);
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+        return true;
+    }
+#endif
+#ifdef UTF8_RENDER_SSE2
+    const __m128i nonAscii = sizeof(wchar_t) == 4 ? _mm_set1_epi32(~0x7F) : _mm_set1_epi16(static_cast<short>(~0x7F));
+    const int vectors = static_cast<int>(16 * sizeof(wchar_t) / 16);
+    __m128i chars[4];
+    __m128i all = _mm_setzero_si128();
+    for (int i = 0; i < vectors; ++i) {
+        chars[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text) + i);
+        all = _mm_or_si128(all, chars[i]);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(all, nonAscii), _mm_setzero_si128())) != 0xFFFF) return false;
+    __m128i bytes = sizeof(wchar_t) == 4
+        ? _mm_packus_epi16(_mm_packs_epi32(chars[0], chars[1]), _mm_packs_epi32(chars[2], chars[3]))
+        : _mm_packus_epi16(chars[0], chars[1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+    return true;
+#else
+    for (int i = 0; i < 16; ++i) {
+        if (static_cast<uint32_t>(text[i]) >= 0x80) return false;
+    }
+    for (int i = 0; i < 16; ++i) out[i] = static_cast<unsigned char>(text[i]);
+    return true;
+#endif
+}
+
+// Appends wide text to result as UTF-8
+void appendWideAsUtf8(const wchar_t* text, size_t length, std::string& result)
+{
+    // UTF-8 takes at most 4 bytes per UTF-32 or 3 bytes per UTF-16 unit
+    const size_t maxBytes = sizeof(wchar_t) == 2 ? 3 : 4;
+    size_t start = result.size();
+    result.resize(start + maxBytes * length);
+    auto out = reinterpret_cast<unsigned char*>(&result[start]);
+
+    size_t i = 0;
+    while (i < length) {
+        if (i + 16 <= length && packAscii16(text + i, out)) {
+            i += 16;
+            out += 16;
+            continue;
+        }
+        // one character at a time until the next ASCII run
+        size_t stop = std::min(length, i + 16);
+        while (i < stop) {
+            uint32_t codePoint = static_cast<uint32_t>(text[i++]);
+            if (codePoint < 0x80) {
+                *out++ = static_cast<unsigned char>(codePoint);
+                continue;
+            }
+            if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint <= 0xDBFF && i < length
+                && static_cast<uint32_t>(text[i]) >= 0xDC00 && static_cast<uint32_t>(text[i]) <= 0xDFFF) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<uint32_t>(text[i++]) - 0xDC00);
+            } else if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+                codePoint = 0xFFFD;
+            }
+            out = writeUtf8(out, codePoint);
+        }
+    }
+    result.resize(static_cast<size_t>(out - reinterpret_cast<unsigned char*>(&result[0])));
+}
+
+// Appends name of Ident of any flavour as UTF-8
+void appendIdentNameUtf8(const Node* node, std::string& result)
+{
+    if (node->type != T_IdentEncoded) {
+        IdentName name = identName(node);
+        appendWideAsUtf8(name.data, name.length, result);
+        return;
+    }
+    auto ident = static_cast<const IdentEncoded*>(node);
+    if (ident->encoding != IdentEncodingUtf16) {
+        result.append(reinterpret_cast<const char*>(ident->bytes()), ident->size);
+        return;
+    }
+    unsigned char buffer[4];
+    forEachIdentCodePoint(ident, [&](uint32_t codePoint) {
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF) codePoint = 0xFFFD;
+        result.append(reinterpret_cast<const char*>(buffer), static_cast<size_t>(writeUtf8(buffer, codePoint) - buffer));
+    });
+}
+
+// The same as reverse_impl_* for List but renders UTF-8
+// O(n) time complexity, O(n) space complexity
+std::string reverse_impl_utf8(const List& list)
+{
+    std::vector<const Node*> nodes;
+    nodes.reserve(static_cast<size_t>(list.length));
+    for (auto cell : list) nodes.push_back(castNode<Node>(cell));
+
+    std::string result;
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        if (it != nodes.rbegin()) result.push_back('.');
+        appendIdentNameUtf8(*it, result);
+    }
+    return result;
+}
+
+#endif
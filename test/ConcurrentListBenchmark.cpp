@@ -0,0 +1,78 @@
+//
+// Micro-benchmark of concurrent appends:
+// 32 producer threads push to ConcurrentList (CAS on the last cell)
+// and to List guarded by std::mutex (push_back under lock)
+// Run by ctest, fails if any element is lost; timings are only printed.
+//
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "concurrent_list.h"
+
+const int Producers = 32;
+const int PerProducer = 20000;
+
+// Runs push(t, value) from Producers threads, returns time in ms
+template<typename Push>
+double runProducers(Push push)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < Producers; ++t) {
+        threads.emplace_back([&push, t]() {
+            for (int i = 0; i < PerProducer; ++i) push(t * PerProducer + i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Checks that list holds every pushed element once
+bool complete(const List& list)
+{
+    std::vector<bool> seen(static_cast<size_t>(Producers) * PerProducer, false);
+    int count = 0;
+    for (auto cell : list) {
+        size_t value = static_cast<size_t>(cell->data.int_value);
+        if (value >= seen.size() || seen[value]) return false;
+        seen[value] = true;
+        ++count;
+    }
+    return count == Producers * PerProducer && list.length == count;
+}
+
+void report(const char* title, double ms)
+{
+    double total = static_cast<double>(Producers) * PerProducer;
+    printf("%-28s %10.2f ms (%.1f M pushes/s)\n", title, ms, total / ms / 1000.0);
+}
+
+int main()
+{
+    printf("%d producers, %d pushes each, %u hardware threads\n", Producers, PerProducer, std::thread::hardware_concurrency());
+
+    ConcurrentList clist;
+    double lockFree = runProducers([&clist](int value) { clist.push_back(value); });
+    List drained = clist.drain();
+    report("ConcurrentList::push_back", lockFree);
+
+    List locked = makeList();
+    std::mutex mutex;
+    double mutexed = runProducers([&](int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        push_back(locked, value);
+    });
+    report("push_back under std::mutex", mutexed);
+    printf("speedup %.1fx\n", mutexed / lockFree);
+
+    bool ok = complete(drained) && complete(locked);
+    clean(drained);
+    clean(locked);
+    if (!ok) {
+        printf("elements lost or duplicated\n");
+        return 1;
+    }
+    return 0;
+}
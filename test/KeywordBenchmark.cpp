@@ -0,0 +1,77 @@
+//
+// Micro-benchmark of SQL keyword lookup:
+// perfect hash (sqlKeywordLookup) against std::unordered_map
+// Words are a mix of keywords in different cases and plain identifiers.
+// Run by ctest, fails if lookups disagree; timings are only printed.
+//
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sql_keywords.h"
+
+template<typename F>
+double measure(const char* title, F f, long& found)
+{
+    auto start = std::chrono::steady_clock::now();
+    found = f();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%-28s %10.2f ms (%ld found)\n", title, ms, found);
+    return ms;
+}
+
+int main()
+{
+    std::vector<std::string> words;
+    for (size_t k = 0; k < SqlKeywordCount; ++k) {
+        std::string word(SqlKeywords[k].name);
+        words.push_back(word);
+        for (auto& c : word) c = static_cast<char>(toupper(c));
+        words.push_back(word);
+        words.push_back(word + "_id");
+        words.push_back("t" + std::to_string(k));
+    }
+    std::vector<std::wstring> wideWords;
+    for (auto& word : words) wideWords.push_back(std::wstring(word.begin(), word.end()));
+
+    std::unordered_map<std::string, int> map;
+    for (size_t k = 0; k < SqlKeywordCount; ++k) map.emplace(SqlKeywords[k].name, static_cast<int>(k));
+
+    const int rounds = 2000;
+    long foundHashed = 0, foundPerfect = 0, foundWide = 0;
+    double hashed = measure("unordered_map (folded copy)", [&] {
+        long found = 0;
+        std::string folded;
+        for (int r = 0; r < rounds; ++r) {
+            for (auto& word : words) {
+                folded.assign(word);
+                for (auto& c : folded) c = static_cast<char>(tolower(c));
+                auto it = map.find(folded);
+                found += it != map.end() ? it->second >= 0 : 0;
+            }
+        }
+        return found;
+    }, foundHashed);
+    double perfect = measure("sqlKeywordLookup (char)", [&] {
+        long found = 0;
+        for (int r = 0; r < rounds; ++r) {
+            for (auto& word : words) found += sqlKeywordLookup(word.data(), word.size()) >= 0;
+        }
+        return found;
+    }, foundPerfect);
+    measure("sqlKeywordLookup (wchar_t)", [&] {
+        long found = 0;
+        for (int r = 0; r < rounds; ++r) {
+            for (auto& word : wideWords) found += sqlKeywordLookup(word.data(), word.size()) >= 0;
+        }
+        return found;
+    }, foundWide);
+    printf("speedup %.1fx\n", hashed / perfect);
+    if (foundPerfect != foundHashed || foundWide != foundHashed) {
+        printf("lookups disagree\n");
+        return 1;
+    }
+    return 0;
+}
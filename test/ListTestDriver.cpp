@@ -1,307 +1,1944 @@
-//
-// This file contains tests regarding
-// reverse implementations as well as generic List handling
-// To work with List structure in more convenient way
-// new API was provided as well as AutoList<> type that allows to use it in similar way as
-// other STL containers. For instance, List can be used with STL algorithms
-//
-
-#include <functional>
-#include "list_tools.h"
-#include "std_list_trait.h"
-#include "reverse_impl.h"
-
-#include "gtest/gtest.h"
-
-// Converts vector of wstrings to List of Idents*
-List buildList(const std::vector<std::wstring>& arg)
-{
-    List list = makeList();
-    for (auto elem : arg) {
-        push_back(list, makeIdent(elem.c_str()));
-    }
-    return list;
-}
-
-// Converts vector of wstrings to std::list of Node*
-std::list<Node*> buildStdList(const std::vector<std::wstring>& arg)
-{
-    std::list<Node*> stdlist;
-    for (auto elem : arg) {
-        stdlist.push_back(makeIdent(elem.c_str()));
-    }
-    return stdlist;
-}
-
-// Contains input and result set for reverse implementations
-std::vector<std::pair<std::vector<std::wstring>, std::wstring>> reverseInputOutput = {
-    {{ L"" }, L"" },
-    {{ L"delak" }, L"delak" },
-    {{ L"delak", L"bolek" }, L"bolek.delak" },
-    {{ L"delak", L"bolek", L"patryk", L"monika", L"milosz" }, L"milosz.monika.patryk.bolek.delak" }
-};
-
-void cleanNodes(const List& list)
-{
-    std::for_each(begin(list), end(list), [&](const ListCell* cell) {
-        delete castNode<Node>(cell);
-    });
-}
-
-// Helper method that takes function as parameter
-// and goes through  whole input set checking result
-// works on List container
-template<typename T>
-void reverseTestHelper(const T& fun)
-{
-    for (auto rio : reverseInputOutput) {
-        List list = buildList(rio.first);
-        EXPECT_EQ(list_length(&list), rio.first.size());
-        const auto& expectedResult = rio.second;
-        auto result = fun(list);
-        EXPECT_EQ(result, expectedResult);
-        cleanNodes(list);
-        clean(list);
-        EXPECT_EQ(list_length(&list), 0);
-    }
-}
-
-// The same as above but works for std::list
-template<typename T>
-void reverseStdListTestHelper(const T& fun)
-{
-    for (auto rio : reverseInputOutput) {
-        std::list<Node*> stdlist = buildStdList(rio.first);
-        EXPECT_EQ(stdlist.size(), rio.first.size());
-        const auto& expectedResult = rio.second;
-        auto result = fun(stdlist);
-        EXPECT_EQ(result, expectedResult);
-        std::for_each(stdlist.begin(), stdlist.end(), [](const Node* n) { delete n;});
-    }
-}
-
-// Helper function that takes two List(s) and 
-// checks them against equality
-void CheckEQList(const List& list1, const List& list2)
-{
-    EXPECT_EQ(list_length(&list1), list_length(&list2));
-    
-    auto list1_begin = begin(list1);
-    auto list1_end = end(list1);
-    auto list2_begin = begin(list2);
-
-    std::for_each(list1_begin, list1_end, [&](const ListCell* cell) {
-        auto l1Value = std::wstring(castNode<Ident>(cell)->name);
-        auto l2Value = std::wstring(castNode<Ident>(*list2_begin)->name);
-        ++list2_begin;
-        EXPECT_EQ(l1Value, l2Value);
-    });    
-}
-
-// Reverse test against all reverse implementations
-// works on List type
-TEST(ListTest, test_reverse)
-{
-    reverseTestHelper([](const List& list) { return reverse_impl_1(list);});
-    reverseTestHelper([](const List& list) { return reverse_impl_2(list);});
-    reverseTestHelper([](const List& list) { return reverse_impl_3(list);});
-    reverseTestHelper([](List& list) { return reverse_impl_4(list);});
-
-}
-
-// Reverse test against all reverse implementations
-// works on std::list type
-TEST(ListTest, test_reverse_std_list)
-{
-    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_1(list);});
-    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_2(list);});
-    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_3(list);});
-    reverseStdListTestHelper([](std::list<Node*>& stdlist) { return reverse_impl_4(stdlist);});
-}
-
-// Test std::find_if with List container
-TEST(ListTest, test_find)
-{
-    List list = buildList({L"delak", L"bolek", L"patryk"});
-
-    auto b = begin(list);
-    auto e = end(list);
-   
-    auto it = std::find_if(b, e, [](const ListCell* cell) {
-        const wchar_t *buff = castNode<Ident>(cell)->name;
-        std::wstring str(buff);
-        return str == L"bolek";
-    });
-    EXPECT_EQ(castNode<Ident>(*it)->name, std::wstring(L"bolek"));
-    EXPECT_EQ(list_length(&list) , 3);
-    cleanNodes(list);
-    clean(list);
-    EXPECT_EQ(list_length(&list) , 0);
-}
-
-// Tests removing middle element from List container
-TEST(ListTest, test_erase1)
-{
-    List list = buildList({ L"delak", L"bolek", L"patryk" });
-    List resultList = buildList({ L"delak", L"patryk" });
-
-    auto b = begin(list);
-    auto e = end(list);
-    
-    auto it = std::find_if(b, e, [](const ListCell* cell) {
-        const wchar_t *buff = castNode<Ident>(cell)->name;
-        std::wstring str(buff);
-        return str == L"bolek";
-    });
-    delete castNode<Node>(*it);
-    erase(it);
-    EXPECT_EQ(list_length(&list) , 2);
-    CheckEQList(list, resultList);
-    cleanNodes(list);
-    clean(list);
-    cleanNodes(resultList);
-    clean(resultList);
-    EXPECT_EQ(list_length(&list) , 0);
-}
-
-// Tests removing last element from 2-elements List container
-TEST(ListTest, test_erase2)
-{
-    List list = buildList({ L"delak", L"bolek" });
-    List resultList = buildList({ L"delak" });
-    auto b = begin(list);
-    auto e = end(list);
-
-    auto it = std::find_if(b, e, [](const ListCell* cell) {
-        const wchar_t *buff = castNode<Ident>(cell)->name;
-        std::wstring str(buff);
-        return str == L"bolek";
-    });
-    delete castNode<Node>(*it);
-    erase(it);
-    EXPECT_EQ(list_length(&list) , 1);
-    CheckEQList(list, resultList);
-    cleanNodes(list);
-    clean(list);
-    cleanNodes(resultList);
-    clean(resultList);
-    EXPECT_EQ(list_length(&list) , 0);
-}
-
-// Tests removing first element from 2-elements List container
-TEST(ListTest, test_erase3)
-{
-    List list = buildList({ L"delak", L"bolek" });
-    List resultList = buildList({ L"bolek" });
-    auto b = begin(list);
-    auto e = end(list);
-
-    auto it = std::find_if(b, e, [](const ListCell* cell) {
-        return std::wstring(castNode<Ident>(cell)->name) == L"delak";
-    });
-    BasicListIterator itSecond = it;
-    ++itSecond;
-    delete castNode<Node>(*it);
-    erase(it);
-    EXPECT_EQ(list_length(&list) , 1);
-    CheckEQList(list, resultList);
-    cleanNodes(list);
-    cleanNodes(resultList);
-    clean(list);
-    clean(resultList);
-    EXPECT_EQ(list_length(&list) , 0);
-}
-
-// Tests removing element from 1-element List
-TEST(ListTest, test_erase4)
-{
-    List list = buildList({ L"delak" });
-
-    auto b = begin(list);
-    EXPECT_EQ(list_length(&list) , 1);
-    delete castNode<Node>(*b);
-    erase(b);
-    EXPECT_EQ(list_length(&list) , 0);
-}
-
-// Tests ListHolder against releasing resources
-TEST(ListTest, test_ListHolder)
-{
-    List list = buildList({ L"delak", L"bolek", L"patryk", L"monika", L"milosz" });
-    {
-        ListHolder listHolder(list);
-        cleanNodes(list);
-    }
-
-    EXPECT_EQ(list_length(&list) , 0);
-
-}
-
-TEST(ListTest, test_copy_node)
-{
-    List list = buildList({ L"delak", L"bolek", L"patryk", L"monika", L"milosz" });
-    auto cloneF = [](const ListCell* cell) {
-        return makeIdent(castNode<Ident>(cell)->name);
-    };
-    auto listCopy = copy(list, cloneF);
-    CheckEQList(list, listCopy);
-    cleanNodes(list);
-    cleanNodes(listCopy);
-    clean(list);
-    clean(listCopy);
-}
-
-TEST(ListTest, test_copy_int)
-{
-    List list = makeList();
-    push_back(list, 1);
-    push_back(list, 2);
-    push_back(list, 3);
-    auto cloneF = [](const ListCell* cell) {
-        return cell->data.int_value;
-    };
-    auto listCopy = copy(list, cloneF);
-    auto it = begin(listCopy);
-    EXPECT_EQ(list_length(&list), list_length(&listCopy));
-
-    std::for_each(begin(list), end(list), [&](const ListCell* cell) {
-        EXPECT_EQ(cell->data.int_value, (*it)->data.int_value);
-        ++it;
-    });
-    clean(list);
-    clean(listCopy);
-}
-
-TEST(ListTest, test_autolist_int)
-{
-    AutoList<int> alist;
-    alist.push_back(1);
-    alist.push_back(2);
-    alist.push_back(3);
-    EXPECT_EQ(alist.size(), 3);
-    AutoList<int> alistCopy = alist;
-    EXPECT_EQ(alistCopy.size(), 3);
-}
-
-TEST(ListTest, test_autolist_node)
-{
-    auto cloneF = [](const ListCell* cell) {
-        return makeIdent(castNode<Ident>(cell)->name);
-    };
-
-    AutoList<Node> alist(cloneF);
-    alist.push_back(makeIdent(L"delak"));
-    alist.push_back(makeIdent(L"bolek"));
-    alist.push_back(makeIdent(L"monika"));
-    EXPECT_EQ(alist.size(), 3);
-    AutoList<Node> alistCopy = alist;
-    EXPECT_EQ(alistCopy.size(), 3);
-}
-
-
-int main(int argc, char* argv[]) 
-{    
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-    
-}
+//
+// This file contains tests regarding
+// reverse implementations as well as generic List handling
+// To work with List structure in more convenient way
+// new API was provided as well as AutoList<> type that allows to use it in similar way as
+// other STL containers. For instance, List can be used with STL algorithms
+//
+
+#include <climits>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include "list_tools.h"
+#include "std_list_trait.h"
+#include "reverse_impl.h"
+#include "flat_list.h"
+#include "parse_cache_file.h"
+#include "statement_cache.h"
+#include "tree_walker.h"
+#include "concurrent_list.h"
+#include "published_list.h"
+#include "epoch_reclamation.h"
+#include "alloc_set_context.h"
+#include "bulk_list.h"
+#include "qualified_name_parser.h"
+#include "utf8_render.h"
+#include "ident_quoting.h"
+#include "qualified_name_compare.h"
+#include "name_resolution_trie.h"
+#include "reversed_name_builder.h"
+#include "indexed_list.h"
+
+#include "gtest/gtest.h"
+
+// Converts vector of wstrings to List of Idents*
+List buildList(const std::vector<std::wstring>& arg)
+{
+    List list = makeList();
+    for (auto elem : arg) {
+        push_back(list, makeIdent(elem.c_str()));
+    }
+    return list;
+}
+
+// Converts vector of wstrings to List of encoded Idents
+List buildEncodedList(const std::vector<std::wstring>& arg, IdentStorage storage)
+{
+    List list = makeList();
+    for (auto& elem : arg) push_back(list, makeIdentEncoded(elem, storage));
+    return list;
+}
+
+// Converts vector of wstrings to std::list of Node*
+std::list<Node*> buildStdList(const std::vector<std::wstring>& arg)
+{
+    std::list<Node*> stdlist;
+    for (auto elem : arg) {
+        stdlist.push_back(makeIdent(elem.c_str()));
+    }
+    return stdlist;
+}
+
+// Contains input and result set for reverse implementations
+std::vector<std::pair<std::vector<std::wstring>, std::wstring>> reverseInputOutput = {
+    {{ L"" }, L"" },
+    {{ L"delak" }, L"delak" },
+    {{ L"delak", L"bolek" }, L"bolek.delak" },
+    {{ L"delak", L"bolek", L"patryk", L"monika", L"milosz" }, L"milosz.monika.patryk.bolek.delak" }
+};
+
+void cleanNodes(const List& list)
+{
+    std::for_each(begin(list), end(list), [&](const ListCell* cell) {
+        delete castNode<Node>(cell);
+    });
+}
+
+// Helper method that takes function as parameter
+// and goes through  whole input set checking result
+// works on List container
+template<typename T>
+void reverseTestHelper(const T& fun)
+{
+    for (auto rio : reverseInputOutput) {
+        List list = buildList(rio.first);
+        EXPECT_EQ(list_length(&list), rio.first.size());
+        const auto& expectedResult = rio.second;
+        auto result = fun(list);
+        EXPECT_EQ(result, expectedResult);
+        cleanNodes(list);
+        clean(list);
+        EXPECT_EQ(list_length(&list), 0);
+    }
+}
+
+// The same as above but works for std::list
+template<typename T>
+void reverseStdListTestHelper(const T& fun)
+{
+    for (auto rio : reverseInputOutput) {
+        std::list<Node*> stdlist = buildStdList(rio.first);
+        EXPECT_EQ(stdlist.size(), rio.first.size());
+        const auto& expectedResult = rio.second;
+        auto result = fun(stdlist);
+        EXPECT_EQ(result, expectedResult);
+        std::for_each(stdlist.begin(), stdlist.end(), [](const Node* n) { delete n;});
+    }
+}
+
+// Helper function that takes two List(s) and 
+// checks them against equality
+void CheckEQList(const List& list1, const List& list2)
+{
+    EXPECT_EQ(list_length(&list1), list_length(&list2));
+    
+    auto list1_begin = begin(list1);
+    auto list1_end = end(list1);
+    auto list2_begin = begin(list2);
+
+    std::for_each(list1_begin, list1_end, [&](const ListCell* cell) {
+        auto l1Value = std::wstring(castNode<Ident>(cell)->name);
+        auto l2Value = std::wstring(castNode<Ident>(*list2_begin)->name);
+        ++list2_begin;
+        EXPECT_EQ(l1Value, l2Value);
+    });    
+}
+
+// Reverse test against all reverse implementations
+// works on List type
+TEST(ListTest, test_reverse)
+{
+    reverseTestHelper([](const List& list) { return reverse_impl_1(list);});
+    reverseTestHelper([](const List& list) { return reverse_impl_2(list);});
+    reverseTestHelper([](const List& list) { return reverse_impl_3(list);});
+    reverseTestHelper([](List& list) { return reverse_impl_4(list);});
+
+}
+
+// Reverse test against all reverse implementations
+// works on std::list type
+TEST(ListTest, test_reverse_std_list)
+{
+    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_1(list);});
+    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_2(list);});
+    reverseStdListTestHelper([](const std::list<Node*>& list) { return reverse_impl_3(list);});
+    reverseStdListTestHelper([](std::list<Node*>& stdlist) { return reverse_impl_4(stdlist);});
+}
+
+// Test std::find_if with List container
+TEST(ListTest, test_find)
+{
+    List list = buildList({L"delak", L"bolek", L"patryk"});
+
+    auto b = begin(list);
+    auto e = end(list);
+   
+    auto it = std::find_if(b, e, [](const ListCell* cell) {
+        const wchar_t *buff = castNode<Ident>(cell)->name;
+        std::wstring str(buff);
+        return str == L"bolek";
+    });
+    EXPECT_EQ(castNode<Ident>(*it)->name, std::wstring(L"bolek"));
+    EXPECT_EQ(list_length(&list) , 3);
+    cleanNodes(list);
+    clean(list);
+    EXPECT_EQ(list_length(&list) , 0);
+}
+
+// Tests removing middle element from List container
+TEST(ListTest, test_erase1)
+{
+    List list = buildList({ L"delak", L"bolek", L"patryk" });
+    List resultList = buildList({ L"delak", L"patryk" });
+
+    auto b = begin(list);
+    auto e = end(list);
+    
+    auto it = std::find_if(b, e, [](const ListCell* cell) {
+        const wchar_t *buff = castNode<Ident>(cell)->name;
+        std::wstring str(buff);
+        return str == L"bolek";
+    });
+    delete castNode<Node>(*it);
+    erase(it);
+    EXPECT_EQ(list_length(&list) , 2);
+    CheckEQList(list, resultList);
+    cleanNodes(list);
+    clean(list);
+    cleanNodes(resultList);
+    clean(resultList);
+    EXPECT_EQ(list_length(&list) , 0);
+}
+
+// Tests removing last element from 2-elements List container
+TEST(ListTest, test_erase2)
+{
+    List list = buildList({ L"delak", L"bolek" });
+    List resultList = buildList({ L"delak" });
+    auto b = begin(list);
+    auto e = end(list);
+
+    auto it = std::find_if(b, e, [](const ListCell* cell) {
+        const wchar_t *buff = castNode<Ident>(cell)->name;
+        std::wstring str(buff);
+        return str == L"bolek";
+    });
+    delete castNode<Node>(*it);
+    erase(it);
+    EXPECT_EQ(list_length(&list) , 1);
+    CheckEQList(list, resultList);
+    cleanNodes(list);
+    clean(list);
+    cleanNodes(resultList);
+    clean(resultList);
+    EXPECT_EQ(list_length(&list) , 0);
+}
+
+// Tests removing first element from 2-elements List container
+TEST(ListTest, test_erase3)
+{
+    List list = buildList({ L"delak", L"bolek" });
+    List resultList = buildList({ L"bolek" });
+    auto b = begin(list);
+    auto e = end(list);
+
+    auto it = std::find_if(b, e, [](const ListCell* cell) {
+        return std::wstring(castNode<Ident>(cell)->name) == L"delak";
+    });
+    BasicListIterator itSecond = it;
+    ++itSecond;
+    delete castNode<Node>(*it);
+    erase(it);
+    EXPECT_EQ(list_length(&list) , 1);
+    CheckEQList(list, resultList);
+    cleanNodes(list);
+    cleanNodes(resultList);
+    clean(list);
+    clean(resultList);
+    EXPECT_EQ(list_length(&list) , 0);
+}
+
+// Tests removing element from 1-element List
+TEST(ListTest, test_erase4)
+{
+    List list = buildList({ L"delak" });
+
+    auto b = begin(list);
+    EXPECT_EQ(list_length(&list) , 1);
+    delete castNode<Node>(*b);
+    erase(b);
+    EXPECT_EQ(list_length(&list) , 0);
+}
+
+// Tests ListHolder against releasing resources
+TEST(ListTest, test_ListHolder)
+{
+    List list = buildList({ L"delak", L"bolek", L"patryk", L"monika", L"milosz" });
+    {
+        ListHolder listHolder(list);
+        cleanNodes(list);
+    }
+
+    EXPECT_EQ(list_length(&list) , 0);
+
+}
+
+TEST(ListTest, test_copy_node)
+{
+    List list = buildList({ L"delak", L"bolek", L"patryk", L"monika", L"milosz" });
+    auto cloneF = [](const ListCell* cell) {
+        return makeIdent(castNode<Ident>(cell)->name);
+    };
+    auto listCopy = copy(list, cloneF);
+    CheckEQList(list, listCopy);
+    cleanNodes(list);
+    cleanNodes(listCopy);
+    clean(list);
+    clean(listCopy);
+}
+
+TEST(ListTest, test_copy_int)
+{
+    List list = makeList();
+    push_back(list, 1);
+    push_back(list, 2);
+    push_back(list, 3);
+    auto cloneF = [](const ListCell* cell) {
+        return cell->data.int_value;
+    };
+    auto listCopy = copy(list, cloneF);
+    auto it = begin(listCopy);
+    EXPECT_EQ(list_length(&list), list_length(&listCopy));
+
+    std::for_each(begin(list), end(list), [&](const ListCell* cell) {
+        EXPECT_EQ(cell->data.int_value, (*it)->data.int_value);
+        ++it;
+    });
+    clean(list);
+    clean(listCopy);
+}
+
+TEST(ListTest, test_autolist_int)
+{
+    AutoList<int> alist;
+    alist.push_back(1);
+    alist.push_back(2);
+    alist.push_back(3);
+    EXPECT_EQ(alist.size(), 3);
+    AutoList<int> alistCopy = alist;
+    EXPECT_EQ(alistCopy.size(), 3);
+}
+
+TEST(ListTest, test_autolist_node)
+{
+    auto cloneF = [](const ListCell* cell) {
+        return makeIdent(castNode<Ident>(cell)->name);
+    };
+
+    AutoList<Node> alist(cloneF);
+    alist.push_back(makeIdent(L"delak"));
+    alist.push_back(makeIdent(L"bolek"));
+    alist.push_back(makeIdent(L"monika"));
+    EXPECT_EQ(alist.size(), 3);
+    AutoList<Node> alistCopy = alist;
+    EXPECT_EQ(alistCopy.size(), 3);
+}
+
+// Reverse test against flat (relocatable) copy of List
+TEST(ListTest, test_flat_list_reverse)
+{
+    for (auto rio : reverseInputOutput) {
+        List list = buildList(rio.first);
+        auto buffer = flattenList(list);
+        cleanNodes(list);
+        clean(list);
+
+        auto view = FlatListView::fromBuffer(buffer.data(), buffer.size());
+        EXPECT_EQ(view.length(), static_cast<int>(rio.first.size()));
+        EXPECT_EQ(reverse_impl_1(view), rio.second);
+        EXPECT_EQ(reverse_impl_2(view), rio.second);
+        EXPECT_EQ(reverse_impl_3(view), rio.second);
+    }
+}
+
+// Flat list does not depend on its address
+// and keeps nested lists and int lists
+TEST(ListTest, test_flat_list_relocate)
+{
+    List inner = buildList({ L"delak", L"bolek" });
+    List ints = makeList();
+    ints.type = T_IntList;
+    push_back(ints, 1);
+    push_back(ints, -2);
+    List list = makeList();
+    push_back(list, makeIdent(L"patryk"));
+    push_back(list, static_cast<Node*>(&inner));
+    push_back(list, static_cast<Node*>(&ints));
+
+    auto buffer = flattenList(list);
+    std::vector<char> moved(buffer.begin(), buffer.end());
+    buffer.assign(buffer.size(), 0);
+
+    auto view = FlatListView::fromBuffer(moved.data(), moved.size());
+    ASSERT_EQ(view.length(), 3);
+    auto it = begin(view);
+    EXPECT_EQ(flatCellNode(*it)->type, T_Ident);
+    ++it;
+    EXPECT_EQ(reverse_impl_1(flatCellList(*it)), L"bolek.delak");
+    ++it;
+    auto intView = flatCellList(*it);
+    EXPECT_EQ(intView.type(), T_IntList);
+    EXPECT_EQ(flatCellInt(intView.head()), 1);
+    EXPECT_EQ(flatCellInt(intView.tail()), -2);
+    EXPECT_EQ(++it, end(view));
+    // nested lists are not taken for names
+    EXPECT_THROW(reverse_impl_1(view), std::invalid_argument);
+    EXPECT_THROW(reverse_impl_3(view), std::invalid_argument);
+
+    EXPECT_THROW(FlatListView::fromBuffer(buffer.data(), buffer.size()), std::invalid_argument);
+
+    // content is validated, not only the header
+    auto corrupted = [&](size_t offset, int32_t value) {
+        std::vector<char> copy(moved);
+        memcpy(&copy[offset], &value, sizeof(value));
+        return copy;
+    };
+    const size_t root = sizeof(FlatHeader);
+    for (auto block : { corrupted(root + offsetof(FlatList, length), 4), corrupted(root + offsetof(FlatList, head), 1 << 20),
+        corrupted(root + offsetof(FlatList, tail), -64), corrupted(root + offsetof(FlatList, type), T_Ident) }) {
+        EXPECT_THROW(FlatListView::fromBuffer(block.data(), block.size()), std::invalid_argument);
+    }
+    EXPECT_THROW(FlatListView::fromBuffer(moved.data(), moved.size() - 8), std::invalid_argument);
+
+    delete castNode<Node>(list.head);
+    cleanNodes(inner);
+    clean(inner);
+    clean(ints);
+    clean(list);
+}
+
+// Parse cache file keeps trees between instances (restarts)
+TEST(ListTest, test_parse_cache_file)
+{
+    std::string path = ::testing::TempDir() + "starcounterpg_parse_cache.log";
+    std::remove(path.c_str());
+
+    List list = buildList({ L"delak", L"bolek", L"patryk" });
+    {
+        ParseCacheFile cache(path);
+        EXPECT_TRUE(cache.store(T_PrepareStmt, L"PREPARE p AS SELECT 1", list));
+        EXPECT_FALSE(cache.store(T_PrepareStmt, L"PREPARE p AS SELECT 1", list));
+        EXPECT_TRUE(cache.store(T_ExecuteStmt, L"EXECUTE p", list));
+        EXPECT_THROW(cache.store(T_SelectStmt, L"SELECT 1", list), std::invalid_argument);
+    }
+    cleanNodes(list);
+    clean(list);
+
+    ParseCacheFile cache(path);
+    EXPECT_EQ(cache.size(), 2u);
+    std::vector<char> tree;
+    EXPECT_FALSE(cache.lookup(T_ExecuteStmt, L"EXECUTE q", tree));
+    EXPECT_FALSE(cache.lookup(T_ExecuteStmt, L"PREPARE p AS SELECT 1", tree));
+    ASSERT_TRUE(cache.lookup(T_PrepareStmt, L"PREPARE p AS SELECT 1", tree));
+    EXPECT_EQ(reverse_impl_1(FlatListView::fromBuffer(tree.data(), tree.size())), L"patryk.bolek.delak");
+
+    // damaged tree of the last record is detected by checksum
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-8, std::ios::end);
+        file.put('x');
+    }
+    ParseCacheFile damaged(path);
+    EXPECT_THROW(damaged.lookup(T_ExecuteStmt, L"EXECUTE p", tree), std::runtime_error);
+    EXPECT_TRUE(damaged.lookup(T_PrepareStmt, L"PREPARE p AS SELECT 1", tree));
+    std::remove(path.c_str());
+}
+
+// Statement cache evicts trees not used since the last clock pass
+// and handles stay valid after eviction
+TEST(ListTest, test_statement_cache)
+{
+    List list = buildList({ L"delak", L"bolek", L"patryk" });
+    StatementCache cache(1 << 20);
+
+    auto first = cache.insert(T_PrepareStmt, L"PREPARE a AS SELECT 1", list);
+    size_t entrySize = cache.stats().bytes;
+    cache.setBudget(entrySize * 2);
+    cache.insert(T_PrepareStmt, L"PREPARE b AS SELECT 1", list);
+    EXPECT_NE(cache.lookup(T_PrepareStmt, L"PREPARE a AS SELECT 1"), nullptr);
+    cache.insert(T_PrepareStmt, L"PREPARE c AS SELECT 1", list);
+    cleanNodes(list);
+    clean(list);
+
+    EXPECT_EQ(cache.lookup(T_PrepareStmt, L"PREPARE b AS SELECT 1"), nullptr);
+    auto handle = cache.lookup(T_PrepareStmt, L"PREPARE a AS SELECT 1");
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(handle, first);
+    EXPECT_TRUE(cache.deallocate(T_PrepareStmt, L"PREPARE a AS SELECT 1"));
+    EXPECT_FALSE(cache.deallocate(T_PrepareStmt, L"PREPARE a AS SELECT 1"));
+    EXPECT_EQ(reverse_impl_1(handle->tree()), L"patryk.bolek.delak");
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.insertions, 3u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+// Concurrent lookups share the same tree
+TEST(ListTest, test_statement_cache_concurrent)
+{
+    List list = buildList({ L"delak", L"bolek" });
+    StatementCache cache(1 << 20);
+    cache.insert(T_ExecuteStmt, L"EXECUTE a", list);
+    cleanNodes(list);
+    clean(list);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                auto handle = cache.lookup(T_ExecuteStmt, L"EXECUTE a");
+                EXPECT_EQ(handle->tree().length(), 2);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(cache.stats().hits, 4000u);
+
+    // lookups of other statements run while one thread inserts and evicts
+    list = buildList({ L"patryk" });
+    size_t budget = cache.stats().bytes * 4;
+    cache.setBudget(budget);
+    threads.clear();
+    threads.emplace_back([&]() {
+        for (int i = 0; i < 200; ++i) cache.insert(T_PrepareStmt, L"PREPARE p" + std::to_wstring(i % 10), list);
+    });
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                auto handle = cache.lookup(T_PrepareStmt, L"PREPARE p" + std::to_wstring((i + t) % 10));
+                if (handle) {
+                    EXPECT_EQ(reverse_impl_1(handle->tree()), L"patryk");
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    cleanNodes(list);
+    clean(list);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 7000u);
+    EXPECT_LE(stats.bytes, budget);
+    EXPECT_GT(stats.evictions, 0u);
+}
+
+// Builds tree (delak, (bolek, patryk), (monika, (milosz)))
+Node* buildTree()
+{
+    List* inner = makeListHeap().release();
+    push_back(*inner, makeIdent(L"milosz"));
+    List* right = makeListHeap().release();
+    push_back(*right, makeIdent(L"monika"));
+    push_back(*right, static_cast<Node*>(inner));
+    List* left = makeListHeap().release();
+    push_back(*left, makeIdent(L"bolek"));
+    push_back(*left, makeIdent(L"patryk"));
+    List* root = makeListHeap().release();
+    push_back(*root, makeIdent(L"delak"));
+    push_back(*root, static_cast<Node*>(left));
+    push_back(*root, static_cast<Node*>(right));
+    return root;
+}
+
+// Collects names of Idents visited by walkTree
+std::wstring walkNames(Node* root, const std::wstring& stop)
+{
+    std::wstring names;
+    walkTree(root, [&](Node* node) {
+        if (node->type != T_Ident) return WalkContinue;
+        std::wstring name = static_cast<Ident*>(node)->name;
+        if (name == stop) return WalkStop;
+        names.append(name);
+        return WalkContinue;
+    });
+    return names;
+}
+
+TEST(ListTest, test_walk_tree)
+{
+    Node* root = buildTree();
+    EXPECT_EQ(walkNames(root, L""), L"delakbolekpatrykmonikamilosz");
+    EXPECT_EQ(walkNames(root, L"monika"), L"delakbolekpatryk");
+
+    int visited = 0;
+    walkTree(root, [&](Node* node) {
+        ++visited;
+        return node != root && node->type == T_List ? WalkSkipChildren : WalkContinue;
+    });
+    EXPECT_EQ(visited, 4);
+
+    // int and oid lists are leaves, their cells are freed with the tree
+    for (NodeTag tag : { T_IntList, T_OidList }) {
+        auto leaf = makeListHeap();
+        leaf->type = tag;
+        push_back(*leaf, 1);
+        push_back(*leaf, 2);
+        push_back(*static_cast<List*>(root), static_cast<Node*>(leaf.release()));
+    }
+    EXPECT_EQ(walkNames(root, L""), L"delakbolekpatrykmonikamilosz");
+    freeTree(root);
+}
+
+// Mutator copies only lists on the path to changed node
+TEST(ListTest, test_mutate_tree)
+{
+    Node* root = buildTree();
+    Node* patryk = makeIdent(L"patryk2");
+    MutatedTree mutated = mutateTree(root, [&](Node* node) {
+        if (node->type == T_Ident && std::wstring(static_cast<Ident*>(node)->name) == L"patryk") return patryk;
+        return node;
+    });
+    Node* result = mutated.root;
+    // new root and new left list are owned by the result
+    EXPECT_EQ(mutated.lists.size(), 2u);
+    EXPECT_EQ(walkNames(root, L""), L"delakbolekpatrykmonikamilosz");
+    EXPECT_EQ(walkNames(result, L""), L"delakbolekpatryk2monikamilosz");
+
+    List* original = static_cast<List*>(root);
+    List* changed = static_cast<List*>(result);
+    ASSERT_NE(original, changed);
+    EXPECT_EQ(castNode<Node>(original->head), castNode<Node>(changed->head));
+    EXPECT_NE(castNode<Node>(original->head->next), castNode<Node>(changed->head->next));
+    EXPECT_EQ(castNode<Node>(original->tail), castNode<Node>(changed->tail));
+
+    auto identity = [](Node* node) { return node; };
+    MutatedTree same = mutateTree(root, identity);
+    EXPECT_EQ(same.root, root);
+    EXPECT_TRUE(same.lists.empty());
+
+    // nodes of other kinds are not silently taken for leaves
+    List withValue = makeList();
+    Node value;
+    value.type = T_Value;
+    push_back(withValue, &value);
+    EXPECT_THROW(walkTree(&withValue, [](Node*) { return WalkContinue; }), std::invalid_argument);
+    EXPECT_THROW(mutateTree(&withValue, identity), std::invalid_argument);
+    clean(withValue);
+
+    mutated = MutatedTree();
+    delete patryk;
+    freeTree(root);
+}
+
+// Walker and mutator do not recurse so deep trees are handled
+TEST(ListTest, test_walk_deep_tree)
+{
+    const int depth = 200000;
+    Node* root = makeIdent(L"leaf");
+    for (int i = 0; i < depth; ++i) {
+        List* list = makeListHeap().release();
+        push_back(*list, root);
+        root = list;
+    }
+    int lists = 0;
+    EXPECT_TRUE(walkTree(root, [&](Node* node) {
+        if (node->type == T_List) ++lists;
+        return WalkContinue;
+    }));
+    EXPECT_EQ(lists, depth);
+    auto identity = [](Node* node) { return node; };
+    EXPECT_EQ(mutateTree(root, identity).root, root);
+    freeTree(root);
+}
+
+// Builds shared tree (delak, (bolek, patryk), (monika))
+Node* buildSharedTree()
+{
+    SharedList* left = makeSharedList();
+    push_back(*left, makeSharedIdent(L"bolek"));
+    push_back(*left, makeSharedIdent(L"patryk"));
+    SharedList* right = makeSharedList();
+    push_back(*right, makeSharedIdent(L"monika"));
+    SharedList* root = makeSharedList();
+    push_back(*root, makeSharedIdent(L"delak"));
+    push_back(*root, static_cast<Node*>(left));
+    push_back(*root, static_cast<Node*>(right));
+    return root;
+}
+
+int refCount(Node* node)
+{
+    return dynamic_cast<RefCounted*>(node)->refCount;
+}
+
+// Rewritten shared tree shares untouched subtrees with original
+TEST(ListTest, test_mutate_shared_tree)
+{
+    Node* root = buildSharedTree();
+    Node* result = mutateSharedTree(root, [](Node* node) {
+        if (node->type == T_Ident && std::wstring(static_cast<Ident*>(node)->name) == L"patryk") {
+            return makeSharedIdent(L"patryk2");
+        }
+        return node;
+    });
+    EXPECT_EQ(walkNames(root, L""), L"delakbolekpatrykmonika");
+    EXPECT_EQ(walkNames(result, L""), L"delakbolekpatryk2monika");
+    EXPECT_TRUE(isSharedNode(result));
+
+    List* original = static_cast<List*>(root);
+    List* changed = static_cast<List*>(result);
+    EXPECT_EQ(castNode<Node>(original->tail), castNode<Node>(changed->tail));
+    EXPECT_EQ(refCount(castNode<Node>(original->tail)), 2);
+    EXPECT_EQ(refCount(castNode<Node>(original->head)), 2);
+    EXPECT_EQ(refCount(castNode<Node>(original->head->next)), 1);
+
+    releaseNode(root);
+    EXPECT_EQ(refCount(castNode<Node>(changed->tail)), 1);
+    EXPECT_EQ(walkNames(result, L""), L"delakbolekpatryk2monika");
+
+    auto identity = [](Node* node) { return node; };
+    Node* same = mutateSharedTree(result, identity);
+    EXPECT_EQ(same, result);
+    EXPECT_EQ(refCount(result), 2);
+    releaseNode(same);
+    releaseNode(result);
+}
+
+// AutoList of shared nodes copies references instead of nodes
+TEST(ListTest, test_autolist_shared_node)
+{
+    auto shareF = [](const ListCell* cell) {
+        return retainNode(castNode<Node>(cell));
+    };
+    Node* delak = makeSharedIdent(L"delak");
+    {
+        AutoList<Node> alist(shareF);
+        alist.push_back(delak);
+        AutoList<Node> alistCopy = alist;
+        EXPECT_EQ(castNode<Node>(*alistCopy.begin()), delak);
+        EXPECT_EQ(refCount(delak), 2);
+        retainNode(delak);
+    }
+    EXPECT_EQ(refCount(delak), 1);
+    releaseNode(delak);
+
+    Node* plain = makeIdent(L"bolek");
+    EXPECT_FALSE(isSharedNode(plain));
+    EXPECT_THROW(retainNode(plain), std::invalid_argument);
+    releaseNode(plain);
+
+    // plain list nested in shared one is cleaned with its nodes
+    SharedList* shared = makeSharedList();
+    Node* tola = makeSharedIdent(L"tola");
+    auto nested = makeListHeap();
+    push_back(*nested, makeIdent(L"lolek"));
+    push_back(*nested, retainNode(tola));
+    push_back(*shared, static_cast<Node*>(nested.release()));
+    EXPECT_FALSE(isSharedNode(castNode<Node>(shared->head)));
+    releaseNode(shared);
+    EXPECT_EQ(refCount(tola), 1);
+    releaseNode(tola);
+}
+
+// Many producers push to ConcurrentList while consumer drains it,
+// every element is received once and in producer order
+TEST(ListTest, test_concurrent_list)
+{
+    const int producers = 8;
+    const int perProducer = 20000;
+    ConcurrentList clist;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&clist, t]() {
+            for (int i = 0; i < perProducer; ++i) clist.push_back(t * perProducer + i);
+        });
+    }
+
+    std::vector<int> lastSeen(producers, -1);
+    int received = 0;
+    while (received < producers * perProducer) {
+        List list = clist.drain();
+        std::for_each(begin(list), end(list), [&](const ListCell* cell) {
+            int producer = cell->data.int_value / perProducer;
+            EXPECT_LT(lastSeen[producer], cell->data.int_value);
+            lastSeen[producer] = cell->data.int_value;
+        });
+        if (list.length) {
+            EXPECT_EQ(list.tail->next, nullptr);
+        }
+        received += list.length;
+        clean(list);
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(received, producers * perProducer);
+    EXPECT_EQ(clist.size(), 0);
+
+    clist.push_back(1);
+    clist.push_back(2);
+    List list = clist.drain();
+    EXPECT_EQ(list.head->data.int_value, 1);
+    EXPECT_EQ(list.tail->data.int_value, 2);
+    clean(list);
+}
+
+// Readers walk published list while single writer appends to it
+// (run under ThreadSanitizer to check publication)
+TEST(ListTest, test_published_list_stress)
+{
+    const int elements = 20000;
+    PublishedList plist;
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            int lastLength = 0;
+            while (!done.load()) {
+                auto snapshot = plist.snapshot();
+                EXPECT_GE(snapshot.length, lastLength);
+                lastLength = snapshot.length;
+                int expected = 0;
+                std::for_each(begin(snapshot), end(snapshot), [&](const ListCell* cell) {
+                    EXPECT_EQ(cell->data.int_value, expected);
+                    ++expected;
+                });
+                EXPECT_EQ(expected, snapshot.length);
+            }
+        });
+    }
+    for (int i = 0; i < elements; ++i) plist.push_back(i);
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(plist.snapshot().length, elements);
+}
+
+// Published list snapshot works with reverse implementations
+TEST(ListTest, test_published_list_reverse)
+{
+    PublishedList plist;
+    EXPECT_EQ(reverse_impl_1(plist.snapshot()), L"");
+    plist.push_back(makeIdent(L"delak"));
+    auto first = plist.snapshot();
+    plist.push_back(makeIdent(L"bolek"));
+    EXPECT_EQ(reverse_impl_1(first), L"delak");
+    EXPECT_EQ(reverse_impl_2(plist.snapshot()), L"bolek.delak");
+    EXPECT_EQ(reverse_impl_3(plist.snapshot()), L"bolek.delak");
+    cleanNodes(plist.writerList());
+}
+
+// Retired pointer is not freed while reader is in critical section
+TEST(ListTest, test_epoch_reclamation)
+{
+    static int freed = 0;
+    auto deleter = [](void* p) { ++freed; delete static_cast<int*>(p); };
+    freed = 0;
+    {
+        EpochManager manager;
+        EpochParticipant reader(manager);
+        EpochParticipant writer(manager);
+        {
+            EpochGuard guard(reader);
+            writer.retire(new int(1), deleter);
+            for (int i = 0; i < 10; ++i) writer.collect();
+            EXPECT_EQ(freed, 0);
+            EXPECT_EQ(writer.pending(), 1u);
+        }
+        writer.collect();
+        writer.collect();
+        EXPECT_EQ(freed, 1);
+        EXPECT_EQ(writer.pending(), 0u);
+        // left for manager when participants are gone
+        writer.retire(new int(2), deleter);
+    }
+    EXPECT_EQ(freed, 2);
+}
+
+// Writer erases and appends while readers walk the list,
+// removed cells are reclaimed only when readers left them
+TEST(ListTest, test_published_list_erase_stress)
+{
+    EpochManager manager;
+    PublishedList plist;
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            EpochParticipant participant(manager);
+            while (!done.load()) {
+                EpochGuard guard(participant);
+                auto snapshot = plist.snapshot();
+                int count = 0;
+                int last = -1;
+                std::for_each(begin(snapshot), end(snapshot), [&](const ListCell* cell) {
+                    EXPECT_LT(last, cell->data.int_value);
+                    last = cell->data.int_value;
+                    ++count;
+                });
+                EXPECT_EQ(count, snapshot.length);
+            }
+        });
+    }
+
+    {
+        EpochParticipant writer(manager);
+        for (int i = 0; i < 2000; ++i) {
+            plist.push_back(i);
+            if (i % 3 == 2) {
+                int toErase = i - 1 - (i % 7);
+                plist.erase([&](const ListCell* cell) { return cell->data.int_value == toErase; }, writer);
+            }
+        }
+        EXPECT_TRUE(plist.erase([](const ListCell* cell) { return cell->data.int_value == 0; }, writer));
+        EXPECT_FALSE(plist.erase([](const ListCell* cell) { return cell->data.int_value == 0; }, writer));
+        done = true;
+        for (auto& reader : readers) reader.join();
+    }
+
+    auto snapshot = plist.snapshot();
+    EXPECT_EQ(snapshot.length, list_length(&plist.writerList()));
+    EXPECT_EQ(plist.writerList().tail->data.int_value, 1999);
+}
+
+// Worker threads build lists in their own arenas,
+// lists are used and released in main thread together with arenas
+TEST(ListTest, test_alloc_set_context_threads)
+{
+    const int workers = 4;
+    std::vector<std::unique_ptr<AllocSetContext>> arenas(workers);
+    std::vector<List> lists(workers);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < workers; ++t) {
+        threads.emplace_back([&, t]() {
+            auto arena = std::make_unique<AllocSetContext>();
+            MemoryContextScope scope(arena.get());
+            lists[t] = buildList({ L"delak", L"bolek", L"patryk" });
+            List listCopy = copy(lists[t], [](const ListCell* cell) {
+                return makeIdent(castNode<Ident>(cell)->name);
+            });
+            EXPECT_EQ(getMemoryChunkContext(castNode<Node>(listCopy.head)), arena.get());
+            EXPECT_EQ(getMemoryChunkContext(listCopy.tail), arena.get());
+            arenas[t] = std::move(arena);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(currentMemoryContext(), nullptr);
+    for (int t = 0; t < workers; ++t) {
+        EXPECT_EQ(reverse_impl_1(lists[t]), L"patryk.bolek.delak");
+        EXPECT_GT(arenas[t]->allocatedBytes(), 0u);
+        // releasing single elements is allowed, memory stays in arena
+        auto it = begin(lists[t]);
+        delete castNode<Node>(*it);
+        erase(it);
+        arenas[t].reset();
+    }
+}
+
+// Big chunks get own blocks, reset releases everything
+TEST(ListTest, test_alloc_set_context_reset)
+{
+    AllocSetContext arena(1024);
+    {
+        MemoryContextScope scope(&arena);
+        Node* node = makeIdent(std::wstring(2000, L'x'));
+        EXPECT_EQ(getMemoryChunkContext(static_cast<Ident*>(node)->name), &arena);
+        EXPECT_EQ(getMemoryChunkContext(node), &arena);
+        EXPECT_GE(arena.allocatedBytes(), 2000 * sizeof(wchar_t));
+    }
+    Node* heapNode = makeIdent(L"delak");
+    EXPECT_EQ(getMemoryChunkContext(heapNode), nullptr);
+    delete heapNode;
+    // heap chunks have no header, cell takes exactly its size
+    ListCell* cell = allocCell();
+    EXPECT_EQ(getMemoryChunkContext(cell), nullptr);
+    EXPECT_EQ(PoolSizeClasses[poolSizeClass(sizeof(ListCell))], sizeof(ListCell));
+    freeCell(cell);
+    arena.reset();
+    EXPECT_EQ(arena.allocatedBytes(), 0u);
+}
+
+// Returns allocations and hits of pool size class used by chunks of given size
+std::pair<uint64_t, uint64_t> poolClassCounters(size_t size)
+{
+    auto stats = poolStats()[poolSizeClass(size)];
+    return std::make_pair(stats.allocations, stats.hits);
+}
+
+// Cells and nodes released to heap are reused by next allocations
+TEST(ListTest, test_recycling_pool)
+{
+    List list = buildList({ L"delak", L"bolek", L"patryk" });
+    cleanNodes(list);
+    clean(list);
+
+    auto before = poolClassCounters(sizeof(ListCell));
+    list = buildList({ L"delak", L"bolek", L"patryk" });
+    auto after = poolClassCounters(sizeof(ListCell));
+    EXPECT_EQ(after.first - before.first, 3u);
+    EXPECT_EQ(after.second - before.second, 3u);
+    EXPECT_GT(poolStats()[poolSizeClass(sizeof(ListCell))].hitRate(), 0.0);
+
+    // chunks released in other thread come back through depot
+    std::thread([&]() {
+        cleanNodes(list);
+        clean(list);
+        for (int i = 0; i < 1000; ++i) {
+            List other = buildList({ L"milosz" });
+            cleanNodes(other);
+            clean(other);
+        }
+    }).join();
+    before = poolClassCounters(sizeof(ListCell));
+    list = buildList({ L"delak", L"bolek", L"patryk" });
+    after = poolClassCounters(sizeof(ListCell));
+    EXPECT_EQ(after.second - before.second, 3u);
+    cleanNodes(list);
+    clean(list);
+    EXPECT_EQ(poolSizeClass(PoolMaxChunkSize + 1), -1);
+
+    // statistics include allocations of other running threads,
+    // also ones served from their caches without touching the depot
+    std::atomic<int> step(0);
+    std::thread counted([&]() {
+        List other = buildList(std::vector<std::wstring>(100, L"lolek"));
+        cleanNodes(other);
+        clean(other);
+        step = 1;
+        while (step != 2) std::this_thread::yield();
+        other = buildList(std::vector<std::wstring>(100, L"lolek"));
+        step = 3;
+        while (step != 4) std::this_thread::yield();
+        cleanNodes(other);
+        clean(other);
+    });
+    while (step != 1) std::this_thread::yield();
+    before = poolClassCounters(sizeof(ListCell));
+    step = 2;
+    while (step != 3) std::this_thread::yield();
+    after = poolClassCounters(sizeof(ListCell));
+    EXPECT_EQ(after.first - before.first, 100u);
+    EXPECT_EQ(after.second - before.second, 100u);
+    step = 4;
+    counted.join();
+    EXPECT_EQ(poolClassCounters(sizeof(ListCell)).first - before.first, 100u);
+}
+
+// Released by thread_local destructor after thread cache of the pool
+struct LateReleasedList
+{
+    List list = makeList();
+    ~LateReleasedList()
+    {
+        cleanNodes(list);
+        clean(list);
+    }
+};
+
+// Chunks freed in thread teardown after the pool cache bypass the pool
+TEST(ListTest, test_recycling_pool_teardown)
+{
+    std::thread([]() {
+        // constructed before pool cache of the thread, so destroyed after it
+        static thread_local LateReleasedList late;
+        late.list = buildList({ L"delak", L"bolek" });
+    }).join();
+    List list = buildList({ L"delak", L"bolek" });
+    EXPECT_EQ(reverse_impl_1(list), L"bolek.delak");
+    cleanNodes(list);
+    clean(list);
+}
+
+// Ident list of 1000 elements is built in one block,
+// elements can be released one by one
+TEST(ListTest, test_bulk_ident_list)
+{
+    std::vector<std::wstring> names;
+    for (int i = 0; i < 1000; ++i) names.push_back(L"n" + std::to_wstring(i));
+    List list = makeIdentListFrom(names.begin(), names.end());
+    EXPECT_EQ(list_length(&list), 1000);
+
+    MemoryContext block = getMemoryChunkContext(list.head);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block->type, T_BulkBlockContext);
+    EXPECT_EQ(getMemoryChunkContext(list.tail), block);
+    EXPECT_EQ(getMemoryChunkContext(castNode<Node>(list.tail)), block);
+    EXPECT_EQ(getMemoryChunkContext(castNode<Ident>(list.tail)->name), block);
+
+    std::wstring expected = names.back();
+    for (auto it = names.rbegin() + 1; it != names.rend(); ++it) expected += L"." + *it;
+    EXPECT_EQ(reverse_impl_1(list), expected);
+    EXPECT_EQ(reverse_impl_3(list), expected);
+
+    auto first = begin(list);
+    delete castNode<Node>(*first);
+    erase(first);
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.head)->name), L"n1");
+    cleanNodes(list);
+    clean(list);
+}
+
+// Int and Node* lists, appending to non-empty list
+TEST(ListTest, test_bulk_append_range)
+{
+    List list = list_make_n(1, 2, 3);
+    EXPECT_EQ(list_length(&list), 3);
+    std::vector<int> more = { 4, 5 };
+    appendRange(list, more.begin(), more.end());
+    appendRange(list, more.end(), more.end());
+    EXPECT_EQ(list_length(&list), 5);
+    EXPECT_EQ(list.tail->data.int_value, 5);
+    // lists built one after another share block of the thread
+    EXPECT_EQ(getMemoryChunkContext(list.head), getMemoryChunkContext(list.head->next));
+    EXPECT_EQ(getMemoryChunkContext(list.head), getMemoryChunkContext(list.tail));
+    EXPECT_EQ(getMemoryChunkContext(list.tail)->type, T_BulkBlockContext);
+    int expected = 1;
+    for (auto cell : list) EXPECT_EQ(cell->data.int_value, expected++);
+    clean(list);
+
+    std::vector<Node*> nodes = { makeIdent(L"delak"), makeIdent(L"bolek") };
+    list = makeListFrom(nodes.begin(), nodes.end());
+    push_back(list, makeIdent(L"patryk"));
+    EXPECT_EQ(reverse_impl_1(list), L"patryk.bolek.delak");
+    cleanNodes(list);
+    clean(list);
+
+    // current context is used instead of block
+    AllocSetContext arena;
+    MemoryContextScope scope(&arena);
+    list = list_make_n(1, 2);
+    EXPECT_EQ(getMemoryChunkContext(list.head), &arena);
+    std::vector<std::wstring> names = { L"delak", L"bolek" };
+    list = makeIdentListFrom(names.begin(), names.end());
+    EXPECT_EQ(getMemoryChunkContext(castNode<Ident>(list.tail)->name), &arena);
+    EXPECT_EQ(reverse_impl_2(list), L"bolek.delak");
+}
+
+// Splicing and cutting lists keeps length and tail
+TEST(ListTest, test_list_concat_split)
+{
+    List list = buildList({ L"delak", L"bolek" });
+    List other = buildList({ L"patryk", L"monika" });
+    List empty = makeList();
+    list_concat(list, empty);
+    list_concat(empty, other);
+    EXPECT_EQ(list_length(&other), 0);
+    list_concat(list, empty);
+    EXPECT_EQ(list_length(&list), 4);
+    EXPECT_EQ(empty.head, nullptr);
+    EXPECT_EQ(empty.tail, nullptr);
+    EXPECT_EQ(reverse_impl_1(list), L"monika.patryk.bolek.delak");
+    EXPECT_THROW(list_concat(list, list), std::invalid_argument);
+
+    List extra = buildList({ L"milosz" });
+    List both = list_concat_copy(list, extra);
+    EXPECT_EQ(list_length(&both), 5);
+    EXPECT_EQ(castNode<Node>(both.tail), castNode<Node>(extra.head));
+    EXPECT_EQ(reverse_impl_2(both), L"milosz.monika.patryk.bolek.delak");
+    clean(both);
+
+    List rest = list_split_at(list, 1);
+    EXPECT_EQ(list_length(&list), 1);
+    EXPECT_EQ(list_length(&rest), 3);
+    EXPECT_EQ(reverse_impl_1(list), L"delak");
+    EXPECT_EQ(reverse_impl_1(rest), L"monika.patryk.bolek");
+    List none = list_split_at(list, 5);
+    EXPECT_EQ(none.head, nullptr);
+    list_concat(list, rest);
+
+    // int lists keep their type
+    List ints = makeList();
+    ints.type = T_IntList;
+    for (int i = 1; i <= 4; ++i) push_back(ints, i);
+    List intsCopy = list_concat_copy(ints, ints);
+    EXPECT_EQ(intsCopy.type, T_IntList);
+    EXPECT_EQ(list_length(&intsCopy), 8);
+    List intsRest = list_split_at(ints, 1);
+    EXPECT_EQ(intsRest.type, T_IntList);
+    EXPECT_EQ(intsRest.head->data.int_value, 2);
+    List intsAll = list_split_at(ints, 0);
+    EXPECT_EQ(intsAll.type, T_IntList);
+    EXPECT_EQ(list_length(&ints), 0);
+    clean(intsCopy);
+    clean(intsRest);
+    clean(intsAll);
+
+    std::vector<Node*> dropped = { castNode<Node>(list.head->next->next), castNode<Node>(list.tail) };
+    list_truncate(list, 2);
+    for (auto node : dropped) delete node;
+    EXPECT_EQ(list_length(&list), 2);
+    EXPECT_EQ(list.tail->next, nullptr);
+    EXPECT_EQ(reverse_impl_1(list), L"bolek.delak");
+
+    Node* last = castNode<Node>(list.tail);
+    list_delete_last(list);
+    delete last;
+    EXPECT_EQ(list.head, list.tail);
+    Node* first = castNode<Node>(list.head);
+    list_delete_first(list);
+    delete first;
+    EXPECT_EQ(list_length(&list), 0);
+    EXPECT_EQ(list.tail, nullptr);
+    list_delete_first(list);
+    list_delete_last(list);
+
+    // push_front keeps tail pointing to the last element
+    push_front(list, 2);
+    push_front(list, 1);
+    push_back(list, 3);
+    EXPECT_EQ(list.tail->data.int_value, 3);
+    EXPECT_EQ(list.head->next->data.int_value, 2);
+    clean(list);
+    cleanNodes(extra);
+    clean(extra);
+}
+
+// Positional access to long list goes through skip index,
+// which is rebuilt after every change of the list
+TEST(ListTest, test_list_nth)
+{
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    List list = makeListFrom(values.begin(), values.end());
+    for (int i = 0; i < 1000; i += 7) EXPECT_EQ(list_nth_int(list, i), i);
+    EXPECT_THROW(list_nth_cell(list, 1000), std::out_of_range);
+    EXPECT_THROW(list_nth_cell(list, -1), std::out_of_range);
+
+    IndexedList indexed(list);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(indexed.nth_int(i), i);
+    EXPECT_THROW(indexed.nth_cell(1000), std::out_of_range);
+    EXPECT_THROW(indexed.nth_cell(-1), std::out_of_range);
+
+    indexed.push_front(-1);
+    EXPECT_EQ(indexed.nth_int(500), 499);
+    auto it = begin(list);
+    ++it;
+    indexed.erase(it);
+    EXPECT_EQ(indexed.nth_int(500), 500);
+    indexed.reverse();
+    EXPECT_EQ(indexed.nth_int(0), 999);
+    EXPECT_EQ(indexed.nth_int(998), 1);
+    indexed.truncate(100);
+    EXPECT_EQ(indexed.nth_int(99), 900);
+    EXPECT_THROW(indexed.nth_int(100), std::out_of_range);
+
+    // changes made directly to the list need invalidate
+    list_sort_int(list);
+    indexed.invalidate();
+    EXPECT_EQ(indexed.nth_int(99), 999);
+    EXPECT_EQ(list_nth_int(list, 99), 999);
+    indexed.clean();
+    EXPECT_EQ(list_length(&list), 0);
+
+    // readers index the same list concurrently
+    List nodes = makeList();
+    for (int i = 0; i < 1000; ++i) push_back(nodes, makeIdent(std::to_wstring(i)));
+    IndexedList indexedNodes(nodes);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            for (int i = 999; i >= 0; --i) {
+                EXPECT_EQ(std::wstring(static_cast<Ident*>(indexedNodes.nth(i))->name), std::to_wstring(i));
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    cleanNodes(nodes);
+    indexedNodes.clean();
+}
+
+// Merge sort keeps order of equal elements, radix sort handles negatives
+TEST(ListTest, test_list_sort)
+{
+    List list = buildList({ L"patryk", L"delak", L"bolek", L"delak", L"monika", L"bolek", L"milosz" });
+    std::vector<Node*> nodes;
+    for (auto cell : list) nodes.push_back(castNode<Node>(cell));
+    auto byName = [](const ListCell* a, const ListCell* b) {
+        return wcscmp(castNode<Ident>(a)->name, castNode<Ident>(b)->name) < 0;
+    };
+    list_sort(list, byName);
+    EXPECT_EQ(list_length(&list), 7);
+    EXPECT_EQ(list.tail->next, nullptr);
+    EXPECT_EQ(reverse_impl_1(list), L"patryk.monika.milosz.delak.delak.bolek.bolek");
+    EXPECT_EQ(castNode<Node>(list.head), nodes[2]);
+    EXPECT_EQ(castNode<Node>(list.head->next), nodes[5]);
+    EXPECT_EQ(castNode<Node>(list_nth_cell(list, 2)), nodes[1]);
+    EXPECT_EQ(castNode<Node>(list_nth_cell(list, 3)), nodes[3]);
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.tail)->name), L"patryk");
+    cleanNodes(list);
+    clean(list);
+
+    std::vector<int> values;
+    for (int i = 0; i < 1037; ++i) values.push_back((i * 7919) % 2003 - 1000 + (i % 3 ? 0 : INT_MIN / 2));
+    values.push_back(INT_MAX);
+    values.push_back(INT_MIN);
+    List ints = makeListFrom(values.begin(), values.end());
+    List merged = makeListFrom(values.begin(), values.end());
+    list_sort_int(ints);
+    list_sort(merged, [](const ListCell* a, const ListCell* b) { return a->data.int_value < b->data.int_value; });
+    std::sort(values.begin(), values.end());
+    std::vector<int> sorted, mergeSorted;
+    for (auto cell : ints) sorted.push_back(cell->data.int_value);
+    for (auto cell : merged) mergeSorted.push_back(cell->data.int_value);
+    EXPECT_EQ(sorted, values);
+    EXPECT_EQ(mergeSorted, values);
+    EXPECT_EQ(ints.tail->data.int_value, INT_MAX);
+    EXPECT_EQ(merged.tail->data.int_value, INT_MAX);
+    EXPECT_EQ(ints.tail->next, nullptr);
+    clean(ints);
+    clean(merged);
+}
+
+// Returns int values of list
+std::vector<int> intValues(const List& list)
+{
+    std::vector<int> values;
+    for (auto cell : list) values.push_back(cell->data.int_value);
+    return values;
+}
+
+// Set operations give the same results for short (scanned)
+// and long (hashed) lists and keep order of elements
+TEST(ListTest, test_list_set_operations)
+{
+    for (int size : { 5, 300 }) {
+        std::vector<int> first, second;
+        for (int i = 0; i < size; ++i) first.push_back(i % (size - 1));
+        for (int i = size / 2; i < size + size / 2; ++i) second.push_back(i);
+        List a = makeListFrom(first.begin(), first.end());
+        List b = makeListFrom(second.begin(), second.end());
+        a.type = T_IntList;
+        b.type = T_IntList;
+
+        std::vector<int> expectedUnion(first), expectedIntersection, expectedDifference, expectedUnique;
+        for (int v : second) {
+            if (std::find(expectedUnion.begin(), expectedUnion.end(), v) == expectedUnion.end()) expectedUnion.push_back(v);
+        }
+        for (int v : first) {
+            bool inSecond = std::find(second.begin(), second.end(), v) != second.end();
+            (inSecond ? expectedIntersection : expectedDifference).push_back(v);
+            if (std::find(expectedUnique.begin(), expectedUnique.end(), v) == expectedUnique.end()) expectedUnique.push_back(v);
+        }
+
+        List result = list_union<ListIntKey>(a, b);
+        EXPECT_EQ(intValues(result), expectedUnion);
+        EXPECT_EQ(result.type, T_IntList);
+        EXPECT_EQ(list_length(&result), static_cast<int>(expectedUnion.size()));
+        clean(result);
+        result = list_intersection<ListIntKey>(a, b);
+        EXPECT_EQ(intValues(result), expectedIntersection);
+        EXPECT_EQ(result.type, T_IntList);
+        clean(result);
+        result = list_difference<ListIntKey>(a, b);
+        EXPECT_EQ(intValues(result), expectedDifference);
+        EXPECT_EQ(result.type, T_IntList);
+        clean(result);
+        list_deduplicate<ListIntKey>(a);
+        EXPECT_EQ(intValues(a), expectedUnique);
+        EXPECT_EQ(list_length(&a), static_cast<int>(expectedUnique.size()));
+        EXPECT_EQ(a.tail->data.int_value, expectedUnique.back());
+        clean(a);
+        clean(b);
+    }
+
+    // Idents compared by name and by pointer
+    List idents = buildList({ L"delak", L"bolek", L"delak", L"patryk", L"bolek" });
+    List other = makeList();
+    push_back(other, castNode<Node>(idents.head));
+    push_back(other, makeIdent(L"patryk"));
+    List byName = list_difference<ListIdentNameKey>(idents, other);
+    EXPECT_EQ(reverse_impl_1(byName), L"bolek.bolek");
+    List byPointer = list_difference<ListPointerKey>(idents, other);
+    EXPECT_EQ(reverse_impl_1(byPointer), L"bolek.patryk.delak.bolek");
+    clean(byName);
+    clean(byPointer);
+    delete castNode<Node>(other.tail);
+    clean(other);
+
+    int removed = 0;
+    list_deduplicate(idents, ListIdentNameKey(), [&](ListCell* cell) {
+        delete castNode<Node>(cell);
+        ++removed;
+    });
+    EXPECT_EQ(removed, 2);
+    EXPECT_EQ(reverse_impl_1(idents), L"patryk.bolek.delak");
+    EXPECT_EQ(std::wstring(castNode<Ident>(idents.tail)->name), L"patryk");
+    cleanNodes(idents);
+    clean(idents);
+}
+
+// Parses qualified name and renders it back
+std::wstring parseAndRender(const std::wstring& text)
+{
+    List list = parseQualifiedName(text.c_str(), text.size());
+    std::wstring result = reverse_impl_1(list);
+    cleanNodes(list);
+    clean(list);
+    return result;
+}
+
+// Parser is inverse of reverse renderers, quoted parts
+// keep separators and doubled quotes
+TEST(ListTest, test_parse_qualified_name)
+{
+    for (auto rio : reverseInputOutput) {
+        if (rio.second.empty()) continue;
+        List list = parseQualifiedName(rio.second.c_str(), rio.second.size());
+        EXPECT_EQ(reverse_impl_1(list), rio.second);
+        List expected = buildList(rio.first);
+        CheckEQList(list, expected);
+        cleanNodes(list);
+        clean(list);
+        cleanNodes(expected);
+        clean(expected);
+    }
+    EXPECT_EQ(parseQualifiedName(L"", 0).head, nullptr);
+
+    std::wstring text = L"very_long_schema_name.\"Table.With\"\"Dots\"\"\".c";
+    List list = parseQualifiedName(text.c_str(), text.size());
+    ASSERT_EQ(list_length(&list), 3);
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.head)->name), L"c");
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.head->next)->name), L"Table.With\"Dots\"");
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.tail)->name), L"very_long_schema_name");
+    // one block for everything
+    MemoryContext block = getMemoryChunkContext(list.head);
+    EXPECT_EQ(block->type, T_BulkBlockContext);
+    for (auto cell : list) {
+        EXPECT_EQ(getMemoryChunkContext(cell), block);
+        EXPECT_EQ(getMemoryChunkContext(castNode<Ident>(cell)->name), block);
+    }
+    cleanNodes(list);
+    clean(list);
+
+    EXPECT_EQ(parseAndRender(L"\"\"\"\".x.\"y\""), L"\".x.y");
+    for (std::wstring bad : { L".", L"a.", L".a", L"a..b", L"\"a", L"\"a\"b", L"a\"b\"", L"\"\"", L"a.\"\"\"" }) {
+        EXPECT_THROW(parseQualifiedName(bad.c_str(), bad.size()), std::invalid_argument);
+    }
+}
+
+// UTF-8 names are decoded to wchar_t
+TEST(ListTest, test_parse_qualified_name_utf8)
+{
+    std::string text = "za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87_g\xC4\x99\xC5\x9Bl\xC4\x85_ja\xC5\xBA\xC5\x84.\"\xE2\x82\xAC.\xF0\x9F\x98\x80\"";
+    List list = parseQualifiedName(text.c_str(), text.size());
+    ASSERT_EQ(list_length(&list), 2);
+    EXPECT_EQ(std::wstring(castNode<Ident>(list.tail)->name), L"za\u017c\u00f3\u0142\u0107_g\u0119\u015bl\u0105_ja\u017a\u0144");
+    std::wstring last = castNode<Ident>(list.head)->name;
+    EXPECT_EQ(last, L"\u20ac.\U0001F600");
+    cleanNodes(list);
+    clean(list);
+
+    for (std::string bad : { "\xC3", "a\x80", "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xFF" }) {
+        EXPECT_THROW(parseQualifiedName(bad.c_str(), bad.size()), std::invalid_argument);
+    }
+}
+
+// Views into statement text behave as owning Idents
+TEST(ListTest, test_ident_view)
+{
+    std::wstring statement = L"SELECT delak.bolek.\"pat\"\"ryk\" FROM t";
+    List views = parseQualifiedNameViews(statement.c_str() + 7, 22);
+    ASSERT_EQ(list_length(&views), 3);
+    EXPECT_EQ(castNode<Node>(views.tail)->type, T_IdentView);
+    EXPECT_EQ(castNode<IdentView>(views.tail)->name, statement.c_str() + 7);
+    EXPECT_EQ(castNode<IdentView>(views.tail)->length, 5u);
+    EXPECT_EQ(castNode<Node>(views.head)->type, T_Ident);
+    EXPECT_EQ(identName(castNode<Node>(views.head)).str(), L"pat\"ryk");
+    EXPECT_EQ(getMemoryChunkContext(castNode<Node>(views.tail)), getMemoryChunkContext(castNode<Ident>(views.head)->name));
+    EXPECT_EQ(reverse_impl_1(views), L"delak.bolek.pat\"ryk");
+    EXPECT_EQ(reverse_impl_3(views), L"delak.bolek.pat\"ryk");
+
+    List owning = buildList({ L"pat\"ryk", L"bolek", L"delak" });
+    List difference = list_difference<ListIdentNameKey>(views, owning);
+    EXPECT_EQ(list_length(&difference), 0);
+    EXPECT_TRUE(identName(castNode<Node>(views.head)) == identName(castNode<Node>(owning.head)));
+    EXPECT_TRUE(identName(castNode<Node>(views.head)) != identName(castNode<Node>(owning.tail)));
+    EXPECT_EQ(ListIdentNameKey().hash(views.head->next), ListIdentNameKey().hash(owning.head->next));
+
+    auto flat = flattenList(views);
+    auto flatView = FlatListView::fromBuffer(flat.data(), flat.size());
+    EXPECT_EQ(reverse_impl_1(flatView), L"delak.bolek.pat\"ryk");
+
+    std::list<Node*> stdlist = { makeIdentView(statement.c_str(), 6), makeIdent(L"x") };
+    EXPECT_EQ(reverse_impl_1(stdlist), L"x.SELECT");
+    for (auto node : stdlist) delete node;
+
+    clean(difference);
+    cleanNodes(owning);
+    clean(owning);
+    cleanNodes(views);
+    clean(views);
+}
+
+// Encoded Idents render, compare and hash as wide ones
+TEST(ListTest, test_ident_encoded)
+{
+    std::vector<std::wstring> names = { L"delak", L"b\u00f3lek", L"\u20ac\U0001F600" };
+    List wide = buildList(names);
+    for (IdentStorage storage : { IdentStorageUtf8, IdentStorageUtf16 }) {
+        List encoded = buildEncodedList(names, storage);
+        auto first = static_cast<IdentEncoded*>(castNode<Node>(encoded.head));
+        EXPECT_EQ(first->type, T_IdentEncoded);
+        EXPECT_EQ(first->encoding, IdentEncodingAscii);
+        EXPECT_EQ(first->size, 5u);
+        auto last = static_cast<IdentEncoded*>(castNode<Node>(encoded.tail));
+        EXPECT_EQ(last->encoding, storage == IdentStorageUtf8 ? IdentEncodingUtf8 : IdentEncodingUtf16);
+        EXPECT_EQ(last->size, storage == IdentStorageUtf8 ? 7u : 3u);
+
+        std::vector<uint32_t> codePoints;
+        forEachIdentCodePoint(castNode<Node>(encoded.tail), [&](uint32_t c) { codePoints.push_back(c); });
+        EXPECT_EQ(codePoints, std::vector<uint32_t>({ 0x20AC, 0x1F600 }));
+        EXPECT_EQ(identWideName(castNode<Node>(encoded.head->next)), names[1]);
+        EXPECT_EQ(reverse_impl_1(encoded), reverse_impl_1(wide));
+        EXPECT_EQ(reverse_impl_4(encoded), L"\u20ac\U0001F600.b\u00f3lek.delak");
+        reverse(encoded);
+
+        auto cell = wide.head;
+        for (auto encodedCell : encoded) {
+            EXPECT_TRUE(identNameEquals(castNode<Node>(cell), castNode<Node>(encodedCell)));
+            EXPECT_EQ(identNameHash(castNode<Node>(cell)), identNameHash(castNode<Node>(encodedCell)));
+            cell = cell->next;
+        }
+        EXPECT_FALSE(identNameEquals(castNode<Node>(wide.head), castNode<Node>(encoded.tail)));
+        List difference = list_difference<ListIdentNameKey>(wide, encoded);
+        EXPECT_EQ(list_length(&difference), 0);
+        clean(difference);
+        EXPECT_THROW(identName(castNode<Node>(encoded.head)), std::invalid_argument);
+
+        auto flat = flattenList(encoded);
+        EXPECT_EQ(reverse_impl_1(FlatListView::fromBuffer(flat.data(), flat.size())), reverse_impl_1(wide));
+        cleanNodes(encoded);
+        clean(encoded);
+    }
+    std::vector<Node*> nodes = { makeIdentEncoded(L"b\u00f3lek", 5, IdentStorageUtf8), makeIdentEncoded(L"b\u00f3lek", 5, IdentStorageUtf16),
+        makeIdentEncoded(L"b\u00f3le", IdentStorageUtf16), makeIdent(L"b\u00f3lekk") };
+    EXPECT_TRUE(identNameEquals(nodes[0], nodes[1]));
+    // names being prefix of the other one differ
+    for (size_t i = 0; i < 2; ++i) {
+        EXPECT_FALSE(identNameEquals(nodes[i], nodes[2]));
+        EXPECT_FALSE(identNameEquals(nodes[3], nodes[i]));
+    }
+    for (auto node : nodes) delete node;
+    // names that could not be read back are rejected in any storage
+    std::vector<std::wstring> invalid = { { L'a', static_cast<wchar_t>(0xD800), L'b' }, { static_cast<wchar_t>(0xDC00) } };
+    if (sizeof(wchar_t) == 4) invalid.push_back({ L'a', static_cast<wchar_t>(0x110000) });
+    for (IdentStorage storage : { IdentStorageUtf8, IdentStorageUtf16 }) {
+        for (auto& name : invalid) EXPECT_THROW(makeIdentEncoded(name, storage), std::invalid_argument);
+    }
+    // makeIdent never creates encoded Idents
+    Node* plain = makeIdent(L"delak");
+    EXPECT_EQ(plain->type, T_Ident);
+    delete plain;
+    cleanNodes(wide);
+    clean(wide);
+}
+
+// Converts wide string to UTF-8 one character at a time
+std::string toUtf8(const std::wstring& text)
+{
+    std::string result;
+    forEachWideCodePoint(text.c_str(), text.size(), [&](uint32_t codePoint) {
+        unsigned char buffer[4];
+        result.append(reinterpret_cast<char*>(buffer), static_cast<size_t>(writeUtf8(buffer, codePoint) - buffer));
+    });
+    return result;
+}
+
+// UTF-8 rendering gives the same bytes as wide rendering converted
+// afterwards, for names shorter and longer than vector width
+TEST(ListTest, test_reverse_utf8)
+{
+    for (auto rio : reverseInputOutput) {
+        List list = buildList(rio.first);
+        EXPECT_EQ(reverse_impl_utf8(list), toUtf8(rio.second));
+        cleanNodes(list);
+        clean(list);
+    }
+
+    std::vector<std::wstring> names;
+    for (size_t length = 0; length < 50; ++length) {
+        std::wstring name;
+        for (size_t i = 0; i < length; ++i) name.push_back(static_cast<wchar_t>(L'a' + i % 26));
+        names.push_back(name);
+        if (length) {
+            name[length / 2] = L'\u0142';
+            names.push_back(name);
+            name[length - 1] = static_cast<wchar_t>(0x1F600);
+            names.push_back(name);
+            name[0] = L'\u20ac';
+            names.push_back(name);
+        }
+    }
+    for (auto& name : names) {
+        std::string rendered;
+        appendWideAsUtf8(name.c_str(), name.size(), rendered);
+        EXPECT_EQ(rendered, toUtf8(name));
+    }
+
+    List list = buildList(names);
+    EXPECT_EQ(reverse_impl_utf8(list), toUtf8(reverse_impl_1(list)));
+    for (IdentStorage storage : { IdentStorageUtf8, IdentStorageUtf16 }) {
+        List encoded = buildEncodedList(names, storage);
+        EXPECT_EQ(reverse_impl_utf8(encoded), reverse_impl_utf8(list));
+        cleanNodes(encoded);
+        clean(encoded);
+    }
+    cleanNodes(list);
+    clean(list);
+
+    std::wstring invalid = { L'a', static_cast<wchar_t>(0xD800), L'b' };
+    std::string rendered;
+    appendWideAsUtf8(invalid.c_str(), invalid.size(), rendered);
+    EXPECT_EQ(rendered, "a\xEF\xBF\xBD" "b");
+}
+
+// Names are quoted only when needed and folded in folding mode,
+// the decision is cached on the node
+TEST(ListTest, test_ident_quoting)
+{
+    List list = buildList({ L"public", L"Select", L"my table", L"say \"hi\"", L"1st", L"col_1", L"\u0142" });
+    EXPECT_EQ(reverse_impl_1(renderView<RenderRaw>(list)), reverse_impl_1(list));
+    EXPECT_EQ(reverse_impl_1(renderView<RenderQuoted>(list)),
+        L"\"\u0142\".col_1.\"1st\".\"say \"\"hi\"\"\".\"my table\".\"Select\".public");
+    EXPECT_EQ(reverse_impl_2(renderView<RenderQuoted | RenderFolded>(list)),
+        L"\"\u0142\".col_1.\"1st\".\"say \"\"hi\"\"\".\"my table\".\"select\".public");
+    EXPECT_EQ(reverse_impl_3(renderView<RenderFolded>(list)), L"\u0142.col_1.1st.say \"hi\".my table.select.public");
+    EXPECT_EQ(reverse_impl_utf8(list, RenderQuoted | RenderFolded),
+        toUtf8(reverse_impl_1(renderView<RenderQuoted | RenderFolded>(list))));
+    EXPECT_EQ(castNode<IdentExt>(list.head)->renderFlags.load(), RenderFlagsComputed);
+    EXPECT_EQ(castNode<IdentExt>(list.head->next)->renderFlags.load(), RenderFlagsComputed | RenderFlagQuoteRaw | RenderFlagQuoteFolded);
+
+    // plain PG Ident is classified without caching
+    Ident plain;
+    plain.type = T_Ident;
+    plain.name = L"Select";
+    EXPECT_EQ(identRenderFlags(&plain), RenderFlagsComputed | RenderFlagQuoteRaw | RenderFlagQuoteFolded);
+    EXPECT_TRUE(identNeedsQuoting(&plain, RenderQuoted | RenderFolded));
+    EXPECT_EQ(identRenderFlagsPtr(&plain), nullptr);
+    EXPECT_THROW(markIdentSourceQuoted(&plain), std::invalid_argument);
+
+    // parts quoted in source keep their case when folded
+    std::wstring text = L"Public.\"MyTable\".\"a\"\"B\".Col";
+    for (int views = 0; views < 2; ++views) {
+        List parsed = views ? parseQualifiedNameViews(text.c_str(), text.size()) : parseQualifiedName(text.c_str(), text.size());
+        EXPECT_EQ(reverse_impl_1(renderView<RenderFolded>(parsed)), L"public.MyTable.a\"B.col");
+        EXPECT_EQ(reverse_impl_1(renderView<RenderQuoted | RenderFolded>(parsed)), L"public.\"MyTable\".\"a\"\"B\".col");
+        EXPECT_EQ(reverse_impl_utf8(parsed, RenderQuoted | RenderFolded), "public.\"MyTable\".\"a\"\"B\".col");
+        EXPECT_EQ(reverse_impl_1(renderView<RenderQuoted>(parsed)), L"\"Public\".\"MyTable\".\"a\"\"B\".\"Col\"");
+        cleanNodes(parsed);
+        clean(parsed);
+    }
+
+    // long names go through vector classification
+    std::vector<std::wstring> names = { L"abcdefghijklmnopqrstuvwxyz_0123456789", L"abcdefghijklmnopqrstuvwxyZ_0123456789",
+        L"abcdefghijklmnopqrstuvwxyz-0123456789", L"current_timestamp", L"Current_Timestamp", L"current_timestamps", L"", L"as", L"a" };
+    std::vector<bool> quoteRaw = { false, true, true, true, true, false, true, true, false };
+    std::vector<bool> quoteFolded = { false, false, true, true, true, false, true, true, false };
+    std::list<Node*> stdlist;
+    for (auto& name : names) stdlist.push_back(makeIdent(name));
+    for (auto& name : names) stdlist.push_back(makeIdentEncoded(name, IdentStorageUtf8));
+    size_t i = 0;
+    for (auto node : stdlist) {
+        size_t n = i++ % names.size();
+        EXPECT_EQ(identNeedsQuoting(node, RenderQuoted), quoteRaw[n]);
+        EXPECT_EQ(identNeedsQuoting(node, RenderQuoted | RenderFolded), quoteFolded[n]);
+        EXPECT_FALSE(identNeedsQuoting(node, RenderFolded));
+    }
+    EXPECT_EQ(reverse_impl_1(renderView<RenderQuoted>(stdlist)).substr(0, 9), L"a.\"as\".\"\"");
+    for (auto node : stdlist) delete node;
+
+    // every keyword but unreserved ones is quoted, also when folded
+    for (size_t k = 0; k < SqlKeywordCount; ++k) {
+        const SqlKeyword& keyword = SqlKeywords[k];
+        bool reserved = keyword.category != UnreservedKeyword;
+        EXPECT_EQ(isSqlKeyword(keyword.name, keyword.length), reserved);
+        if (k) {
+            EXPECT_LT(strcmp(SqlKeywords[k - 1].name, keyword.name), 0);
+        }
+        std::wstring name(keyword.name, keyword.name + keyword.length);
+        Node* ident = makeIdent(name);
+        EXPECT_EQ(identNeedsQuoting(ident, RenderQuoted), reserved);
+        EXPECT_EQ(identNeedsQuoting(ident, RenderQuoted | RenderFolded), reserved);
+        delete ident;
+    }
+    EXPECT_TRUE(isSqlKeyword("as", 2));
+    EXPECT_FALSE(isSqlKeyword("ass", 3));
+    EXPECT_FALSE(isSqlKeyword("a", 1));
+    EXPECT_FALSE(isSqlKeyword("zzz", 3));
+    cleanNodes(list);
+    clean(list);
+}
+
+// Perfect hash finds every keyword in any case, narrow or wide
+TEST(ListTest, test_sql_keyword_lookup)
+{
+    for (size_t k = 0; k < SqlKeywordCount; ++k) {
+        const SqlKeyword& keyword = SqlKeywords[k];
+        EXPECT_EQ(strlen(keyword.name), keyword.length);
+        if (k) {
+            EXPECT_LT(strcmp(SqlKeywords[k - 1].name, keyword.name), 0);
+        }
+        std::string upper(keyword.name);
+        std::wstring mixed(upper.begin(), upper.end());
+        for (size_t i = 0; i < upper.size(); ++i) {
+            upper[i] = static_cast<char>(toupper(upper[i]));
+            if (i % 2) mixed[i] = static_cast<wchar_t>(upper[i]);
+        }
+        EXPECT_EQ(sqlKeywordLookup(keyword.name, keyword.length), static_cast<int>(k));
+        EXPECT_EQ(sqlKeywordLookup(upper.c_str(), upper.size()), static_cast<int>(k));
+        EXPECT_EQ(sqlKeywordLookup(mixed.c_str(), mixed.size()), static_cast<int>(k));
+        EXPECT_NE(sqlKeywordLookup(keyword.name, keyword.length - 1), static_cast<int>(k));
+    }
+    EXPECT_EQ(sqlKeywordLookup("SELECT", 6), KW_SELECT);
+    EXPECT_EQ(sqlKeywordLookup(L"Current_Timestamp", 17), KW_CURRENT_TIMESTAMP);
+    EXPECT_EQ(SqlKeywords[KW_ZONE].category, UnreservedKeyword);
+    EXPECT_EQ(sqlKeywordLookup("selects", 7), -1);
+    EXPECT_EQ(sqlKeywordLookup("", 0), -1);
+    EXPECT_EQ(sqlKeywordLookup("current_timestamp_x", 19), -1);
+    EXPECT_EQ(sqlKeywordLookup(L"s\u00E9lect", 6), -1);
+    EXPECT_EQ(sqlKeywordLookup("sel\xC3\xA9" "ct", 7), -1);
+
+    // unreserved keywords can be used as identifiers
+    EXPECT_TRUE(isSqlKeyword("select", 6));
+    EXPECT_TRUE(isSqlKeyword(L"Integer", 7));
+    EXPECT_FALSE(isSqlKeyword("zone", 4));
+}
+
+// Ident lists are compared with dotted text part by part
+TEST(ListTest, test_qualified_name_compare)
+{
+    std::wstring text = L"Schema.table.column";
+    List list = buildList({ L"Schema", L"table", L"column" });
+    List encoded = makeList();
+    for (auto cell : list) push_back(encoded, makeIdentEncoded(identWideName(castNode<Node>(cell)), IdentStorageUtf16));
+    for (const List* names : { &list, &encoded }) {
+        const List& l = *names;
+        EXPECT_TRUE(qualifiedNameEquals(l, text.c_str(), text.size()));
+        EXPECT_TRUE(qualifiedNameEquals(l, L"column.table.Schema", 19, CompareReversed));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"schema.table.column", 19));
+        EXPECT_TRUE(qualifiedNameEquals(l, L"schema.TABLE.column", 19, CompareIgnoreCase));
+        EXPECT_TRUE(qualifiedNameEquals(l, L"COLUMN.table.schema", 19, CompareReversed | CompareIgnoreCase));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"Schema.table", 12));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"Schema.table.column.x", 21));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"table.column", 12, CompareReversed));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"Schema.table.colum", 18));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"Schema.table.column.", 20));
+        EXPECT_FALSE(qualifiedNameEquals(l, L"", 0));
+
+        EXPECT_EQ(qualifiedNameCompare(l, text.c_str(), text.size()), 0);
+        EXPECT_EQ(qualifiedNameCompare(l, L"column.table.Schema", 19, CompareReversed), 0);
+        EXPECT_LT(qualifiedNameCompare(l, L"schema.table.column", 19), 0);
+        EXPECT_EQ(qualifiedNameCompare(l, L"schema.table.column", 19, CompareIgnoreCase), 0);
+        EXPECT_GT(qualifiedNameCompare(l, L"Schema.table", 12), 0);
+        EXPECT_LT(qualifiedNameCompare(l, L"Schema.table.column.a", 21), 0);
+        EXPECT_GT(qualifiedNameCompare(l, L"Schema.tab.zzz", 14), 0);
+        EXPECT_GT(qualifiedNameCompare(l, L"", 0), 0);
+        // reversed order compares from the first part of the text as well
+        EXPECT_LT(qualifiedNameCompare(l, L"column.table.Schema.a", 21, CompareReversed), 0);
+        EXPECT_GT(qualifiedNameCompare(l, L"column.table", 12, CompareReversed), 0);
+        EXPECT_LT(qualifiedNameCompare(l, L"column.tablf.A", 14, CompareReversed), 0);
+        EXPECT_GT(qualifiedNameCompare(l, L"colum.zzz.zzz", 13, CompareReversed), 0);
+    }
+    List empty = makeList();
+    EXPECT_TRUE(qualifiedNameEquals(empty, L"", 0));
+    EXPECT_EQ(qualifiedNameCompare(empty, L"a", 1), -1);
+
+    // parsed names match their text in reversed order
+    std::wstring unicode = L"za\u017c\u00f3\u0142\u0107.\U0001F600";
+    List names = parseQualifiedName(unicode.c_str(), unicode.size());
+    EXPECT_TRUE(qualifiedNameEquals(names, unicode.c_str(), unicode.size(), CompareReversed));
+    push_back(names, makeIdentEncoded(L"\u20ac", IdentStorageUtf8));
+    EXPECT_TRUE(qualifiedNameEquals(names, (L"\u20ac." + unicode).c_str(), unicode.size() + 2, CompareReversed));
+    EXPECT_LT(qualifiedNameCompare(names, L"\u20ad", 1, CompareReversed), 0);
+    cleanNodes(names);
+    clean(names);
+    cleanNodes(encoded);
+    clean(encoded);
+    cleanNodes(list);
+    clean(list);
+}
+
+// Parses qualified name to Ident list (most specific part first)
+List parseName(const std::wstring& text)
+{
+    return parseQualifiedName(text.c_str(), text.size());
+}
+
+// Resolves qualified name in trie snapshot, returns -1 if it is not found
+// and -2 if it is ambiguous
+int resolveName(const NameTrieSnapshot<int>& snapshot, const std::wstring& text)
+{
+    List name = parseName(text);
+    NameResolution<int> resolution = snapshot.resolve(name);
+    cleanNodes(name);
+    clean(name);
+    return resolution.status == NameFound ? *resolution.value : resolution.status == NameAmbiguous ? -2 : -1;
+}
+
+// Full and partially qualified names are resolved in one walk
+TEST(ListTest, test_name_resolution_trie)
+{
+    EpochManager manager;
+    EpochParticipant reader(manager);
+    EpochParticipant writer(manager);
+    NameResolutionTrie<int> trie;
+    std::vector<std::wstring> names = { L"db.public.orders.id", L"db.public.orders.customer_id", L"db.public.customers.id",
+        L"db.public.customers.name", L"db.audit.orders.id", L"db.public.orders", L"db.public.customers" };
+    for (size_t i = 0; i < names.size(); ++i) {
+        List name = parseName(names[i]);
+        trie.insert(name, static_cast<int>(i));
+        EXPECT_THROW(trie.insert(name, 0), std::invalid_argument);
+        cleanNodes(name);
+        clean(name);
+    }
+    EpochGuard guard(reader);
+    EXPECT_EQ(trie.snapshot()->size(), 0u);
+    EXPECT_EQ(resolveName(*trie.snapshot(), L"db.public.orders.id"), -1);
+    trie.publish(writer);
+    const NameTrieSnapshot<int>* snapshot = trie.snapshot();
+    EXPECT_EQ(snapshot->size(), names.size());
+    for (size_t i = 0; i < names.size(); ++i) EXPECT_EQ(resolveName(*snapshot, names[i]), static_cast<int>(i));
+    EXPECT_EQ(resolveName(*snapshot, L"customer_id"), 1);
+    EXPECT_EQ(resolveName(*snapshot, L"name"), 3);
+    EXPECT_EQ(resolveName(*snapshot, L"customers.id"), 2);
+    EXPECT_EQ(resolveName(*snapshot, L"public.orders.id"), 0);
+    EXPECT_EQ(resolveName(*snapshot, L"id"), -2);
+    EXPECT_EQ(resolveName(*snapshot, L"orders.id"), -2);
+    EXPECT_EQ(resolveName(*snapshot, L"orders"), 5);
+    EXPECT_EQ(resolveName(*snapshot, L"public.orders.name"), -1);
+    EXPECT_EQ(resolveName(*snapshot, L"other.db.public.orders.id"), -1);
+    EXPECT_EQ(resolveName(*snapshot, L"ID"), -1);
+    EXPECT_EQ(snapshot->resolve(makeList()).status, NameNotFound);
+
+    // parts are matched with Idents of any flavour
+    List encoded = buildEncodedList({ L"name", L"customers" }, IdentStorageUtf8);
+    NameResolution<int> resolution = snapshot->resolve(encoded);
+    ASSERT_EQ(resolution.status, NameFound);
+    EXPECT_EQ(*resolution.value, 3);
+    cleanNodes(encoded);
+    clean(encoded);
+
+    // old snapshot is not changed nor freed by the writer while reader is in guard
+    List audit = parseName(L"db.audit.orders.id");
+    EXPECT_TRUE(trie.erase(audit));
+    EXPECT_FALSE(trie.erase(audit));
+    cleanNodes(audit);
+    clean(audit);
+    trie.publish(writer);
+    for (int i = 0; i < 4; ++i) writer.collect();
+    EXPECT_EQ(resolveName(*trie.snapshot(), L"orders.id"), 0);
+    EXPECT_EQ(resolveName(*snapshot, L"orders.id"), -2);
+    EXPECT_EQ(trie.snapshot()->size(), names.size() - 1);
+}
+
+// Readers resolve names while writer publishes new snapshots
+TEST(ListTest, test_name_resolution_trie_concurrent)
+{
+    EpochManager manager;
+    EpochParticipant writer(manager);
+    NameResolutionTrie<int> trie;
+    List fixed = parseName(L"s.fixed");
+    trie.insert(fixed, -1);
+    trie.publish(writer);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    std::atomic<int> failures(0);
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            EpochParticipant participant(manager);
+            while (!done.load()) {
+                EpochGuard guard(participant);
+                NameResolution<int> resolution = trie.snapshot()->resolve(fixed);
+                if (resolution.status != NameFound || *resolution.value != -1) ++failures;
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        List name = parseName(L"s.t" + std::to_wstring(i));
+        trie.insert(name, i);
+        cleanNodes(name);
+        clean(name);
+        trie.publish(writer);
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(resolveName(*trie.snapshot(), L"t199"), 199);
+    // replaced snapshots are freed once readers are gone
+    for (int i = 0; i < 3; ++i) writer.collect();
+    EXPECT_EQ(writer.pending(), 0u);
+    cleanNodes(fixed);
+    clean(fixed);
+}
+
+// Rendered name is cached by IndexedList until it is changed or invalidated
+TEST(ListTest, test_list_rendered_name)
+{
+    List list = buildList({ L"column", L"table" });
+    IndexedList indexed(list);
+    const std::wstring* reversed = indexed.rendered_name();
+    EXPECT_EQ(*reversed, L"table.column");
+    EXPECT_EQ(*reversed, reverse_impl_1(list));
+    EXPECT_EQ(indexed.rendered_name(), reversed);
+    EXPECT_EQ(*indexed.rendered_name(ListNameForward), L"column.table");
+    EXPECT_EQ(indexed.rendered_name(ListNameForward), indexed.rendered_name(ListNameForward));
+
+    indexed.push_back(makeIdent(L"schema"));
+    EXPECT_EQ(*indexed.rendered_name(), L"schema.table.column");
+    EXPECT_EQ(indexed.nth(2), castNode<Node>(list.tail));
+    indexed.push_front(makeIdent(L"x"));
+    EXPECT_EQ(*indexed.rendered_name(), L"schema.table.column.x");
+    indexed.reverse();
+    EXPECT_EQ(*indexed.rendered_name(), L"x.column.table.schema");
+    EXPECT_EQ(*indexed.rendered_name(ListNameForward), L"schema.table.column.x");
+    auto last = begin(list);
+    Node* removed = castNode<Node>(*last);
+    indexed.erase(last);
+    delete removed;
+    EXPECT_EQ(*indexed.rendered_name(ListNameForward), L"table.column.x");
+
+    // readers render concurrently, all of them get the published string
+    std::vector<const std::wstring*> rendered(4);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < rendered.size(); ++r) {
+        readers.emplace_back([&, r] { rendered[r] = indexed.rendered_name(ListNameReversed); });
+    }
+    for (auto& reader : readers) reader.join();
+    for (auto name : rendered) EXPECT_EQ(name, indexed.rendered_name());
+    EXPECT_EQ(*indexed.rendered_name(), L"x.column.table");
+
+    // direct change is not seen until invalidate()
+    Node* appended = makeIdent(L"y");
+    push_back(list, appended);
+    EXPECT_EQ(*indexed.rendered_name(), L"x.column.table");
+    indexed.invalidate();
+    EXPECT_EQ(*indexed.rendered_name(), L"y.x.column.table");
+
+    cleanNodes(list);
+    indexed.clean();
+    EXPECT_EQ(*indexed.rendered_name(), L"");
+}
+
+// Rendering is kept up to date while Idents are appended
+TEST(ListTest, test_reversed_name_builder)
+{
+    List list = buildList({ L"delak", L"bolek" });
+    ReversedNameBuilder builder(list);
+    EXPECT_EQ(builder.str(), L"bolek.delak");
+    for (int i = 0; i < 300; ++i) {
+        if (i % 3 == 1) {
+            builder.push_back(makeIdentEncoded(L"za\u017c\u00f3\u0142\u0107" + std::to_wstring(i), i % 2 ? IdentStorageUtf8 : IdentStorageUtf16));
+        } else {
+            builder.push_back(makeIdent(i % 7 ? L"name" + std::to_wstring(i) : std::wstring()));
+        }
+        ASSERT_EQ(builder.str(), reverse_impl_1(list));
+        EXPECT_EQ(builder.c_str()[builder.size()], L'\0');
+    }
+    EXPECT_EQ(list_length(&list), 302);
+    EXPECT_EQ(std::wstring(builder.c_str()), reverse_impl_1(list));
+    cleanNodes(list);
+    clean(list);
+
+    List empty = makeList();
+    ReversedNameBuilder emptyBuilder(empty);
+    EXPECT_EQ(emptyBuilder.size(), 0u);
+    EXPECT_EQ(std::wstring(emptyBuilder.c_str()), L"");
+    emptyBuilder.push_back(makeIdent(L""));
+    emptyBuilder.push_back(makeIdent(L""));
+    EXPECT_EQ(emptyBuilder.str(), L".");
+    cleanNodes(empty);
+    clean(empty);
+}
+
+
+int main(int argc, char* argv[]) 
+{    
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+    
+}
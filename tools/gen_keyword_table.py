@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+#
+# Generates include/sql_keyword_table.h from tools/sql_keywords.txt
+#
+# Keywords get a minimal perfect hash (CHM algorithm): two string hashes
+# h1, h2 map every keyword to an edge of an acyclic graph, vertex values g
+# are chosen so that (g[h1(k)] + g[h2(k)]) % count is the keyword index.
+# Lookup (sql_keywords.h) computes both hashes in one pass over the word
+# and compares it with the single candidate keyword.
+#
+# Line endings: the generated header is written with CRLF, as every
+# header in include/ is. Files in tools/ (this script, sql_keywords.txt)
+# use LF; the keyword list is read in text mode, so either is accepted.
+#
+# Usage: python3 tools/gen_keyword_table.py
+
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, 'tools', 'sql_keywords.txt')
+TARGET = os.path.join(ROOT, 'include', 'sql_keyword_table.h')
+
+CATEGORIES = {
+    'unreserved': 'UnreservedKeyword',
+    'col_name': 'ColNameKeyword',
+    'type_func_name': 'TypeFuncNameKeyword',
+    'reserved': 'ReservedKeyword',
+}
+
+MULTIPLIERS = [31, 127, 257, 8191, 65537, 131071, 524287]
+
+
+def read_keywords():
+    keywords = []
+    with open(SOURCE) as source:
+        for line in source:
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            name, category = line.split()
+            if category not in CATEGORIES:
+                sys.exit('unknown category %s of %s' % (category, name))
+            keywords.append((name, category))
+    names = [name for name, _ in keywords]
+    if names != sorted(set(names)):
+        sys.exit('keywords have to be sorted and unique')
+    return keywords
+
+
+def string_hash(word, multiplier, seed):
+    value = seed
+    for c in word:
+        value = (value * multiplier + ord(c)) & 0xFFFFFFFF
+    return value
+
+
+def find_hash(names):
+    count = len(names)
+    size = 2 * count + 1
+    for seed in range(1, 10000):
+        for multiplier1 in MULTIPLIERS:
+            for multiplier2 in MULTIPLIERS:
+                if multiplier1 == multiplier2:
+                    continue
+                values = assign_values(names, size, multiplier1, multiplier2, seed)
+                if values is not None:
+                    return multiplier1, multiplier2, seed, size, values
+    sys.exit('no perfect hash found')
+
+
+def assign_values(names, size, multiplier1, multiplier2, seed):
+    count = len(names)
+    edges = [[] for _ in range(size)]
+    for index, name in enumerate(names):
+        a = string_hash(name, multiplier1, seed) % size
+        b = string_hash(name, multiplier2, seed + 1) % size
+        if a == b:
+            return None
+        edges[a].append((b, index))
+        edges[b].append((a, index))
+
+    values = [None] * size
+    for root in range(size):
+        if values[root] is not None:
+            continue
+        values[root] = 0
+        stack = [(root, -1)]
+        while stack:
+            vertex, via = stack.pop()
+            for neighbour, index in edges[vertex]:
+                if index == via:
+                    continue
+                if values[neighbour] is not None:
+                    return None  # cycle
+                values[neighbour] = (index - values[vertex]) % count
+                stack.append((neighbour, index))
+    return values
+
+
+def format_rows(items, indent='    ', width=100):
+    lines = []
+    line = indent
+    for item in items:
+        if len(line) + len(item) + 1 > width and line != indent:
+            lines.append(line.rstrip())
+            line = indent
+        line += item + ' '
+    lines.append(line.rstrip())
+    return '\n'.join(lines)
+
+
+def main():
+    keywords = read_keywords()
+    names = [name for name, _ in keywords]
+    multiplier1, multiplier2, seed, size, values = find_hash(names)
+
+    tokens = format_rows(['KW_%s,' % name.upper() for name in names])
+    entries = '\n'.join('    { "%s", %d, %s },' % (name, len(name), CATEGORIES[category])
+                        for name, category in keywords)
+    table = format_rows(['%d,' % value for value in values])
+
+    header = '''#ifndef SQL_KEYWORD_TABLE_H
+#define SQL_KEYWORD_TABLE_H
+
+// Generated by tools/gen_keyword_table.py from tools/sql_keywords.txt
+// Do not edit, regenerate instead
+
+#include <cstddef>
+#include <cstdint>
+
+enum SqlKeywordCategory
+{
+    UnreservedKeyword,
+    ColNameKeyword,
+    TypeFuncNameKeyword,
+    ReservedKeyword
+};
+
+// Token ids, in order of SqlKeywords
+enum SqlKeywordToken
+{
+%(tokens)s
+};
+
+struct SqlKeyword
+{
+    const char* name;
+    size_t length;
+    SqlKeywordCategory category;
+};
+
+const SqlKeyword SqlKeywords[] = {
+%(entries)s
+};
+
+const size_t SqlKeywordCount = %(count)d;
+const size_t SqlKeywordMaxLength = %(maxLength)d;
+
+// Perfect hash: index = (table[h1 %% size] + table[h2 %% size]) %% count
+// h = h * multiplier + character, starting from seed (h1) and seed + 1 (h2)
+const uint32_t SqlKeywordHashMultiplier1 = %(multiplier1)d;
+const uint32_t SqlKeywordHashMultiplier2 = %(multiplier2)d;
+const uint32_t SqlKeywordHashSeed = %(seed)d;
+const uint32_t SqlKeywordHashSize = %(size)d;
+
+const uint16_t SqlKeywordHashTable[] = {
+%(table)s
+};
+
+#endif
+''' % {
+        'tokens': tokens,
+        'entries': entries,
+        'count': len(names),
+        'maxLength': max(len(name) for name in names),
+        'multiplier1': multiplier1,
+        'multiplier2': multiplier2,
+        'seed': seed,
+        'size': size,
+        'table': table,
+    }
+    # CRLF, like the other headers in include/
+    with open(TARGET, 'w', newline='\r\n') as target:
+        target.write(header)
+
+
+if __name__ == '__main__':
+    main()